@@ -0,0 +1,183 @@
+/**
+ * @file      LVGL_Buffering_Benchmark.ino
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2025  Shenzhen Xin Yuan Electronic Technology Co., Ltd
+ * @date      2025-03-18
+ * @note      Run the same animated scene with every lvgl buffering policy and print
+ *            the render and flush time of each one. lvgl can only be registered once,
+ *            so the board restarts between the runs and keeps the results in RTC memory.
+ *            The table is printed to the serial port after the last policy.
+ *            The sketch builds with lvgl 8 and lvgl 9, flash it once with each version
+ *            to compare them on the same scene, every row starts with the lvgl version.
+ */
+#include <LilyGo_AMOLED.h>
+#include <LV_Helper.h>
+#include <esp_attr.h>
+
+#define BENCH_WARMUP_MS     (1000)
+#define BENCH_RUN_MS        (10000)
+#define BENCH_MAGIC         (0x4C564246UL)
+#define BENCH_POLICY_COUNT  (4)
+
+// Stripe height used by the SRAM stripe and hybrid runs, 0 keeps the helper default
+#define BENCH_STRIPE_LINES  (0)
+
+typedef struct {
+    bool done;
+    bool failed;
+    LvHelperStats_t stats;
+} BenchResult_t;
+
+typedef struct {
+    uint32_t magic;
+    uint8_t next;
+    BenchResult_t result[BENCH_POLICY_COUNT];
+} BenchState_t;
+
+RTC_NOINIT_ATTR static BenchState_t state;
+
+#if LVGL_VERSION_MAJOR == 9
+#define bench_anim_time(a, ms)          lv_anim_set_duration(a, ms)
+#define bench_anim_playback(a, ms)      lv_anim_set_playback_duration(a, ms)
+#define bench_timer_data(t)             lv_timer_get_user_data(t)
+#define bench_hor_res()                 lv_display_get_horizontal_resolution(NULL)
+#define bench_ver_res()                 lv_display_get_vertical_resolution(NULL)
+#else
+#define bench_anim_time(a, ms)          lv_anim_set_time(a, ms)
+#define bench_anim_playback(a, ms)      lv_anim_set_playback_time(a, ms)
+#define bench_timer_data(t)             ((t)->user_data)
+#define bench_hor_res()                 lv_disp_get_hor_res(NULL)
+#define bench_ver_res()                 lv_disp_get_ver_res(NULL)
+#endif
+
+LilyGo_Class amoled;
+
+static void anim_x_cb(void *obj, int32_t v)
+{
+    lv_obj_set_x((lv_obj_t *)obj, v);
+}
+
+static void anim_arc_cb(void *obj, int32_t v)
+{
+    lv_arc_set_value((lv_obj_t *)obj, v);
+}
+
+static void counter_cb(lv_timer_t *t)
+{
+    static uint32_t count;
+    lv_label_set_text_fmt((lv_obj_t *)bench_timer_data(t), "%lu", (unsigned long)count++);
+}
+
+// A small changing label, a spinning arc and a block sweeping across the whole width
+static void create_scene()
+{
+    lv_obj_t *scr = lv_scr_act();
+    lv_obj_set_style_bg_color(scr, lv_color_black(), 0);
+
+    lv_obj_t *arc = lv_arc_create(scr);
+    lv_obj_set_size(arc, 120, 120);
+    lv_obj_align(arc, LV_ALIGN_LEFT_MID, 20, 0);
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, arc);
+    lv_anim_set_exec_cb(&a, anim_arc_cb);
+    lv_anim_set_values(&a, 0, 100);
+    bench_anim_time(&a, 1000);
+    bench_anim_playback(&a, 1000);
+    lv_anim_set_repeat_count(&a, LV_ANIM_REPEAT_INFINITE);
+    lv_anim_start(&a);
+
+    lv_obj_t *block = lv_obj_create(scr);
+    lv_obj_set_size(block, 80, bench_ver_res() / 2);
+    lv_obj_align(block, LV_ALIGN_TOP_LEFT, 0, 0);
+    lv_obj_set_style_bg_grad_color(block, lv_palette_main(LV_PALETTE_BLUE), 0);
+    lv_obj_set_style_bg_grad_dir(block, LV_GRAD_DIR_VER, 0);
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, block);
+    lv_anim_set_exec_cb(&a, anim_x_cb);
+    lv_anim_set_values(&a, 0, bench_hor_res() - 80);
+    bench_anim_time(&a, 2000);
+    bench_anim_playback(&a, 2000);
+    lv_anim_set_repeat_count(&a, LV_ANIM_REPEAT_INFINITE);
+    lv_anim_start(&a);
+
+    lv_obj_t *label = lv_label_create(scr);
+    lv_obj_set_style_text_color(label, lv_color_white(), 0);
+    lv_obj_align(label, LV_ALIGN_BOTTOM_RIGHT, -20, -20);
+    lv_timer_create(counter_cb, 50, label);
+}
+
+static void print_results()
+{
+    Serial.printf("Board: %s %ux%u\n", amoled.getName(), amoled.width(), amoled.height());
+    Serial.println("lvgl   policy        frames  fps    render/frame  flush/frame  frame   flushes  Mpx");
+    for (uint8_t i = 0; i < BENCH_POLICY_COUNT; i++) {
+        const char *name = getLvglHelperBufferingName((LvHelperBuffering_t)i);
+        BenchResult_t *r = &state.result[i];
+        Serial.printf("%d.%d.%-2d ", LVGL_VERSION_MAJOR, LVGL_VERSION_MINOR, LVGL_VERSION_PATCH);
+        if (r->failed || !r->stats.frameCount) {
+            Serial.printf("%-12s  %s\n", name, r->failed ? "out of memory" : "no frames");
+            continue;
+        }
+        uint32_t n = r->stats.frameCount;
+        Serial.printf("%-12s  %6lu  %5.1f  %10luus  %9luus  %5luus  %7lu  %.1f\n", name,
+                      (unsigned long)n, n * 1000.0 / BENCH_RUN_MS,
+                      (unsigned long)(r->stats.renderUs / n), (unsigned long)(r->stats.flushUs / n),
+                      (unsigned long)(r->stats.frameUs / n), (unsigned long)r->stats.flushCount,
+                      r->stats.pixelCount / 1000000.0);
+    }
+}
+
+void setup()
+{
+    Serial.begin(115200);
+
+    if (!amoled.begin()) {
+        while (1) {
+            Serial.println("The board model cannot be detected, please raise the Core Debug Level to an error");
+            delay(1000);
+        }
+    }
+
+    // A power on or a reset from outside starts a new series
+    if (state.magic != BENCH_MAGIC || state.next >= BENCH_POLICY_COUNT || esp_reset_reason() != ESP_RST_SW) {
+        memset(&state, 0, sizeof(state));
+        state.magic = BENCH_MAGIC;
+    }
+
+    LvHelperBuffering_t policy = (LvHelperBuffering_t)state.next;
+    Serial.printf("Run %u/%u: %s\n", state.next + 1, BENCH_POLICY_COUNT, getLvglHelperBufferingName(policy));
+
+    BenchResult_t *r = &state.result[state.next];
+    if (beginLvglHelper(amoled, policy, BENCH_STRIPE_LINES)) {
+        create_scene();
+
+        uint32_t end = millis() + BENCH_WARMUP_MS;
+        while (millis() < end) {
+            lv_task_handler();
+            delay(1);
+        }
+        resetLvglHelperStats();
+        end = millis() + BENCH_RUN_MS;
+        while (millis() < end) {
+            lv_task_handler();
+            delay(1);
+        }
+        getLvglHelperStats(&r->stats);
+    } else {
+        r->failed = true;
+    }
+    r->done = true;
+
+    if (++state.next < BENCH_POLICY_COUNT) {
+        Serial.flush();
+        esp_restart();
+    }
+    print_results();
+}
+
+void loop()
+{
+    delay(1000);
+}
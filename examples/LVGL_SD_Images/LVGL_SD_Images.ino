@@ -16,6 +16,7 @@
  */
 #include <LilyGo_AMOLED.h>      //To use LilyGo AMOLED series screens, please include <LilyGo_AMOLED.h>
 #include <LV_Helper.h>
+#include <LV_ImageCache.h>
 #include <AceButton.h>
 #include <vector>
 
@@ -41,6 +42,13 @@ void updateImages()
     lv_img_set_src(img1, images[image_index].c_str());
     image_index++;
     image_index %= images.size();
+
+    // After one round through the card every image is drawn from PSRAM
+    LvImageCacheStats_t stats;
+    getLvglImageCacheStats(&stats);
+    Serial.printf("Image cache hits:%lu misses:%lu entries:%lu %lu/%lu bytes\n",
+                  (unsigned long)stats.hits, (unsigned long)stats.misses, (unsigned long)stats.entries,
+                  (unsigned long)stats.bytes, (unsigned long)stats.budget);
 }
 
 void handleEvent(AceButton * /* button */, uint8_t eventType,
@@ -129,6 +137,9 @@ void setup()
 
     beginLvglHelper(amoled);
 
+    // Keep decoded images in PSRAM, switching back to one skips the decoder
+    beginLvglImageCache();
+
     // Tried to initialize three times
     int retry = 3;
     while (retry--) {
@@ -0,0 +1,193 @@
+/**
+ * @file      PixelKernel_Benchmark.ino
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2025  Shenzhen Xinyuan Electronic Technology Co., Ltd
+ * @date      2025-03-18
+ * @note      Verify the tiled rotation kernel against the scalar reference in all four
+ *            orientations and compare their speed on PSRAM buffers.
+ *            The byte swap kernel is measured at every board resolution, both as a
+ *            separate pass over the frame and folded into the copy to a staging buffer.
+ *            No screen is needed, the results are printed to the serial port.
+ */
+#include <Arduino.h>
+#include <PixelKernel.h>
+
+// Full frame of the 1.47 inch board, plus a few odd sizes to cover the tile edges
+static const uint16_t test_size[][2] = {
+    {368, 194},
+    {600, 450},
+    {33, 17},
+    {1, 7},
+    {7, 1},
+};
+
+// Frame sizes of the 1.47, 1.91 and 2.41 inch boards
+static const uint16_t swap_size[][2] = {
+    {194, 368},
+    {240, 536},
+    {600, 450},
+};
+
+#define BENCH_LOOPS     (10)
+#define STAGE_SIZE      (4096)
+
+static uint16_t *src_buf;
+static uint16_t *ref_buf;
+static uint16_t *dst_buf;
+static uint16_t *stage_buf;
+
+static bool verify(uint16_t w, uint16_t h, uint8_t rotation)
+{
+    for (uint32_t i = 0; i < (uint32_t)w * h; i++) {
+        src_buf[i] = esp_random();
+    }
+    pixel_rotate_scalar(src_buf, ref_buf, w, h, rotation);
+    pixel_rotate(src_buf, dst_buf, w, h, rotation);
+    return memcmp(ref_buf, dst_buf, (uint32_t)w * h * sizeof(uint16_t)) == 0;
+}
+
+static uint32_t bench(void (*fn)(const uint16_t *, uint16_t *, uint16_t, uint16_t, uint8_t),
+                      uint16_t w, uint16_t h, uint8_t rotation)
+{
+    uint32_t start = micros();
+    for (int i = 0; i < BENCH_LOOPS; ++i) {
+        fn(src_buf, dst_buf, w, h, rotation);
+    }
+    return (micros() - start) / BENCH_LOOPS;
+}
+
+static void swap_scalar(uint16_t *p, uint32_t len)
+{
+    while (len--) {
+        *p = (uint16_t)((*p << 8) | (*p >> 8));
+        p++;
+    }
+}
+
+static bool verify_swap(uint32_t len, uint8_t offset)
+{
+    for (uint32_t i = 0; i < len + offset; i++) {
+        src_buf[i] = esp_random();
+    }
+    memcpy(ref_buf, src_buf, (len + offset) * sizeof(uint16_t));
+    swap_scalar(ref_buf + offset, len);
+    pixel_swap(dst_buf + offset, src_buf + offset, len);
+    if (memcmp(ref_buf + offset, dst_buf + offset, len * sizeof(uint16_t))) {
+        return false;
+    }
+    pixel_swap(src_buf + offset, src_buf + offset, len);
+    return memcmp(ref_buf + offset, src_buf + offset, len * sizeof(uint16_t)) == 0;
+}
+
+// The SPI driver copies PSRAM chunks to internal RAM anyway, this is that copy
+static void stage_copy(const uint16_t *src, uint32_t len)
+{
+    while (len) {
+        uint32_t n = len > STAGE_SIZE ? STAGE_SIZE : len;
+        memcpy(stage_buf, src, n * sizeof(uint16_t));
+        src += n;
+        len -= n;
+    }
+}
+
+// And this is the same copy with the swap folded in, as done by setSwapBytes()
+static void stage_swap(const uint16_t *src, uint32_t len)
+{
+    while (len) {
+        uint32_t n = len > STAGE_SIZE ? STAGE_SIZE : len;
+        pixel_swap(stage_buf, src, n);
+        src += n;
+        len -= n;
+    }
+}
+
+static void bench_swap(uint16_t w, uint16_t h)
+{
+    uint32_t len = (uint32_t)w * h;
+    uint32_t t[4];
+
+    uint32_t start = micros();
+    for (int i = 0; i < BENCH_LOOPS; ++i) {
+        swap_scalar(src_buf, len);
+    }
+    t[0] = (micros() - start) / BENCH_LOOPS;
+
+    start = micros();
+    for (int i = 0; i < BENCH_LOOPS; ++i) {
+        pixel_swap(src_buf, src_buf, len);
+    }
+    t[1] = (micros() - start) / BENCH_LOOPS;
+
+    start = micros();
+    for (int i = 0; i < BENCH_LOOPS; ++i) {
+        stage_copy(src_buf, len);
+    }
+    t[2] = (micros() - start) / BENCH_LOOPS;
+
+    start = micros();
+    for (int i = 0; i < BENCH_LOOPS; ++i) {
+        stage_swap(src_buf, len);
+    }
+    t[3] = (micros() - start) / BENCH_LOOPS;
+
+    Serial.printf("swap %ux%u pass scalar:%luus word:%luus staged copy:%luus swap:%luus extra:%ldus\n",
+                  w, h, (unsigned long)t[0], (unsigned long)t[1], (unsigned long)t[2],
+                  (unsigned long)t[3], (long)t[3] - (long)t[2]);
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    delay(2000);
+
+    size_t max_size = 600 * 450 * sizeof(uint16_t);
+    src_buf = (uint16_t *)ps_malloc(max_size);
+    ref_buf = (uint16_t *)ps_malloc(max_size);
+    dst_buf = (uint16_t *)ps_malloc(max_size);
+    stage_buf = (uint16_t *)heap_caps_malloc(STAGE_SIZE * sizeof(uint16_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (!src_buf || !ref_buf || !dst_buf || !stage_buf) {
+        while (1) {
+            Serial.println("PSRAM allocation failed");
+            delay(1000);
+        }
+    }
+
+    bool pass = true;
+    for (auto &s : test_size) {
+        for (uint8_t r = 0; r < 4; ++r) {
+            bool ok = verify(s[0], s[1], r);
+            Serial.printf("verify %3ux%-3u rotation:%u %s\n", s[0], s[1], r, ok ? "PASS" : "FAIL");
+            pass &= ok;
+        }
+    }
+    for (uint8_t offset = 0; offset < 2; ++offset) {
+        for (uint32_t len : {0, 1, 2, 3, 7, 8, 9, 17, 1023}) {
+            bool ok = verify_swap(len, offset);
+            if (!ok) {
+                Serial.printf("verify swap len:%lu offset:%u FAIL\n", (unsigned long)len, offset);
+            }
+            pass &= ok;
+        }
+    }
+    Serial.printf("Correctness: %s\n", pass ? "PASS" : "FAIL");
+
+    for (uint8_t i = 0; i < 2; ++i) {
+        uint16_t w = test_size[i][0];
+        uint16_t h = test_size[i][1];
+        for (uint8_t r = 0; r < 4; ++r) {
+            uint32_t scalar = bench(pixel_rotate_scalar, w, h, r);
+            uint32_t tiled = bench(pixel_rotate, w, h, r);
+            Serial.printf("%ux%u rotation:%u scalar:%luus tiled:%luus\n", w, h, r, (unsigned long)scalar, (unsigned long)tiled);
+        }
+    }
+
+    for (auto &s : swap_size) {
+        bench_swap(s[0], s[1]);
+    }
+}
+
+void loop()
+{
+    delay(1000);
+}
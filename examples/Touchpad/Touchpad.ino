@@ -11,6 +11,7 @@
 
 LilyGo_Class amoled;
 lv_obj_t *label;
+volatile bool homePressed = false;
 
 void setup(void)
 {
@@ -38,6 +39,12 @@ void setup(void)
         }
     }
 
+    // Read the touch controller only after its IRQ fires instead of on every getPoint,
+    // the home button callback below is then called from the touch reader task
+    if (!amoled.enableTouchInterrupt()) {
+        Serial.println("No touch interrupt, the touch controller is polled");
+    }
+
     // Register lvgl helper
     beginLvglHelper(amoled);
 
@@ -48,14 +55,10 @@ void setup(void)
     lv_obj_center(label);
 
     // Only 1.91 Inch AMOLED board support
+    // The callback may run on the touch reader task, lvgl is only called from loop()
     amoled.setHomeButtonCallback([](void *ptr) {
         Serial.println("Home key pressed!");
-        static uint32_t checkMs = 0;
-        if (millis() > checkMs) {
-            lv_label_set_text(label, "Home Pressed");
-            lv_obj_center(label);
-        }
-        checkMs = millis() + 200;
+        homePressed = true;
     }, NULL);
 
 }
@@ -69,6 +72,15 @@ void loop()
         lv_label_set_text_fmt(label, "X:%d Y:%d", x, y);
         lv_obj_center(label);
     }
+    static uint32_t checkMs = 0;
+    if (homePressed) {
+        homePressed = false;
+        if (millis() > checkMs) {
+            lv_label_set_text(label, "Home Pressed");
+            lv_obj_center(label);
+        }
+        checkMs = millis() + 200;
+    }
     lv_task_handler();
     delay(5);
 }
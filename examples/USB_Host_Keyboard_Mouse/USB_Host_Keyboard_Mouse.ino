@@ -50,6 +50,10 @@ LilyGo_Class amoled;
 // Input device parameters
 struct InputParams inputParams;
 
+// One ring per device, the USB task writes and lvgl reads without blocking
+static struct InputRing mouseRing;
+static struct InputRing keyboardRing;
+
 
 // The event handler for the button.
 void handleEvent(AceButton *button, uint8_t eventType, uint8_t buttonState)
@@ -124,12 +128,14 @@ void setup()
     beginLvglHelper(amoled);
 
     // Register USB input device
-    inputParams.queue = xQueueCreate( 10, sizeof( struct InputData  ) );    //Creating an Input Queue
+    inputParams.queue = NULL;
+    inputParams.mouse = &mouseRing;
+    inputParams.keyboard = &keyboardRing;
     inputParams.icon = (const void *)&image_emoji;  //Set mouse pointer icon
     beginLvglInputDevice(inputParams);  //Register lvgl to allow input device input
 
 
-    setupUSB(inputParams.queue);    // Initialize USB Host
+    setupUSB(inputParams);    // Initialize USB Host
 
     // Creating an Input Box
     lv_obj_t *radio_ta = lv_textarea_create(lv_scr_act());
@@ -30,9 +30,19 @@
 static const char *TAG = "example";
 static QueueHandle_t hid_host_event_queue;
 static bool user_shutdown = false;
-static  QueueHandle_t queue_in = NULL;
+static  struct InputParams input = {0};
 static  struct InputData pdat = {0};
 
+// Hand an event to the lvgl side without ever blocking the HID task
+static void input_send(struct InputRing *ring, const struct InputData *in)
+{
+    if (ring) {
+        inputRingPush(ring, in);
+    } else if (input.queue) {
+        xQueueSend(input.queue, in, 0);
+    }
+}
+
 /**
  * @brief HID Host event
  *
@@ -209,20 +219,16 @@ static inline bool hid_keyboard_get_char(uint8_t modifier,
 static inline void hid_keyboard_print_char(unsigned int key_char)
 {
     if (!!key_char) {
-        if (queue_in) {
-            pdat.id = 'k';
-            pdat.key = key_char;
-            xQueueSend(queue_in, &pdat, portMAX_DELAY);
-        }
+        pdat.id = 'k';
+        pdat.key = key_char;
+        input_send(input.keyboard, &pdat);
         putchar(key_char);
 #if (KEYBOARD_ENTER_LF_EXTEND)
         if (KEYBOARD_ENTER_MAIN_CHAR == key_char) {
             putchar('\n');
-            if (queue_in) {
-                pdat.id = 'k';
-                pdat.key = '\n';
-                xQueueSend(queue_in, &pdat, portMAX_DELAY);
-            }
+            pdat.id = 'k';
+            pdat.key = '\n';
+            input_send(input.keyboard, &pdat);
         }
 #endif // KEYBOARD_ENTER_LF_EXTEND
         fflush(stdout);
@@ -336,20 +342,18 @@ static void hid_host_mouse_report_callback(const uint8_t *const data, const int
     hid_print_new_device_report_header(HID_PROTOCOL_MOUSE);
 
 
-    if (queue_in) {
-        pdat.id = 'm';
-        pdat.left = mouse_report->buttons.button1;
-        pdat.right = mouse_report->buttons.button2;
-        pdat.x = x_pos;
-        pdat.y = y_pos;
-        // Serial.printf("X: %06d\tY: %06d\t|%c|%c|\r",
-        //               x_pos, y_pos,
-        //               (mouse_report->buttons.button1 ? 'o' : ' '),
-        //               (mouse_report->buttons.button2 ? 'o' : ' '));
-        // Serial.println();
+    pdat.id = 'm';
+    pdat.left = mouse_report->buttons.button1;
+    pdat.right = mouse_report->buttons.button2;
+    pdat.x = x_pos;
+    pdat.y = y_pos;
+    // Serial.printf("X: %06d\tY: %06d\t|%c|%c|\r",
+    //               x_pos, y_pos,
+    //               (mouse_report->buttons.button1 ? 'o' : ' '),
+    //               (mouse_report->buttons.button2 ? 'o' : ' '));
+    // Serial.println();
 
-        xQueueSend(queue_in, &pdat, portMAX_DELAY);
-    }
+    input_send(input.mouse, &pdat);
 
 }
 
@@ -553,10 +557,10 @@ void hid_host_device_callback(hid_host_device_handle_t hid_device_handle,
     xQueueSend(hid_host_event_queue, &evt_queue, 0);
 }
 
-void setupUSB(QueueHandle_t queue_i)
+void setupUSB(const struct InputParams &params)
 {
 
-    queue_in = queue_i;
+    input = params;
 
     BaseType_t task_created;
     Serial.println("HID Host example");
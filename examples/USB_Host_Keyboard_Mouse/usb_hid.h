@@ -13,6 +13,7 @@
 #include "InputParams.h"
 
 
-void setupUSB(QueueHandle_t queue_i);
+// Events go to the mouse and keyboard rings of params, or to its queue when they are NULL
+void setupUSB(const struct InputParams &params);
 
 
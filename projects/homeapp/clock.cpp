@@ -10,6 +10,10 @@ const char* const DAYS_OF_WEEK[] = {"Sunday", "Monday", "Tuesday", "Wednesday",
 // Month names
 const char* const MONTH_NAMES[] = {"January", "February", "March", "April", "May", "June", "July", "August", "September", "October", "November", "December"};
 
+// Last text posted to the labels
+static char lastDateStr[10];
+static char lastTimeStr[6];
+
 void initClock() {
   // Configure NTP
   configTime(0, 0, "pool.ntp.org", "time.nist.gov");
@@ -39,7 +43,7 @@ void updateClock() {
   unsigned long currentMillis = millis();
   
   // Only update every clockUpdateInterval ms to avoid excessive updates
-  if (currentMillis - lastClockUpdate >= clockUpdateInterval) {
+  if ((long)(currentMillis - lastClockUpdate) >= clockUpdateInterval) {
     lastClockUpdate = currentMillis;
     
     // Get current time
@@ -50,17 +54,21 @@ void updateClock() {
     
     // Format date string: "DD.MM.YY"
     char dateStr[10];
-    snprintf(dateStr, sizeof(dateStr), "%02d.%02d.%02d", 
-             timeinfo.tm_mday,
-             timeinfo.tm_mon + 1, 
-             (timeinfo.tm_year + 1900) % 100);
-    lv_label_set_text(date_label, dateStr);
+    strftime(dateStr, sizeof(dateStr), "%d.%m.%y", &timeinfo);
+    if (strcmp(dateStr, lastDateStr) != 0 &&
+        postLvglTextCall(date_label, setLvglDigitLabelText, dateStr)) {
+      strcpy(lastDateStr, dateStr);
+    }
     
     // Format time string: "HH:MM" (24-hour format)
     char timeStr[6];
     snprintf(timeStr, sizeof(timeStr), "%02d:%02d", 
              timeinfo.tm_hour, 
              timeinfo.tm_min);
-    lv_label_set_text(time_label, timeStr);
+    // Most ticks change nothing, the label redraws only the digits that did
+    if (strcmp(timeStr, lastTimeStr) != 0 &&
+        postLvglTextCall(time_label, setLvglDigitLabelText, timeStr)) {
+      strcpy(lastTimeStr, timeStr);
+    }
   }
 }
\ No newline at end of file
@@ -33,8 +33,10 @@ struct tm timeinfo;
 lv_obj_t *song_title_label;
 lv_obj_t *artist_label;
 lv_obj_t *play_btn;
+lv_obj_t *play_label;
 lv_obj_t *prev_btn;
 lv_obj_t *next_btn;
+lv_obj_t *progress_bar;
 bool isPlaying = false;
 
 
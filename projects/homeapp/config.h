@@ -9,6 +9,10 @@
 #include <Arduino.h>
 #include <LilyGo_AMOLED.h>
 #include <LV_Helper.h>
+#include <LV_Runtime.h>
+#include <LV_ShadowCache.h>
+#include <LV_DigitLabel.h>
+#include <LV_ProgressBar.h>
 #include <WiFi.h>
 #include <time.h>
 
@@ -40,8 +44,10 @@ extern struct tm timeinfo;
 extern lv_obj_t *song_title_label;
 extern lv_obj_t *artist_label;
 extern lv_obj_t *play_btn;
+extern lv_obj_t *play_label;
 extern lv_obj_t *prev_btn;
 extern lv_obj_t *next_btn;
+extern lv_obj_t *progress_bar;
 extern bool isPlaying;
 
 
@@ -0,0 +1,365 @@
+/**
+ * @file      cover.cpp
+ * @brief     Album cover art, fetched and decoded on its own task
+ */
+
+#include "cover.h"
+#include "spotify.h"
+#include "http_keepalive.h"
+#include <freertos/queue.h>
+#include <mbedtls/base64.h>
+#include <extra/libs/sjpg/tjpgd.h>
+
+#define COVER_TASK_STACK 6144
+#define COVER_TIMEOUT_MS 3000
+#define COVER_POST_RETRY_MS 20                  // About a frame, the UI update queue drains once per frame
+#define COVER_ID_LEN 64
+#define COVER_MAX_SIDE 128                      // Largest image kept before scaling to COVER_ART_SIZE
+#define COVER_FETCH_LEN (COVER_MAX_SIDE * COVER_MAX_SIDE * 2)
+#define COVER_JSON_LEN (48 * 1024)              // Holds coverSmall, a base64 JPEG
+#define COVER_JPEG_POOL 4096                    // Work area of the JPEG decoder
+#define COVER_RGB565_PATH "/spotify/cover/rgb565"
+
+lv_obj_t *cover_art = NULL;
+
+struct CoverEntry {
+  char id[COVER_ID_LEN];      // Empty while unused
+  uint32_t lastUsed;
+  lv_img_dsc_t dsc;
+};
+
+struct CoverRequest {
+  char id[COVER_ID_LEN];
+};
+
+// Owned by the cover task. The entry on screen is never written, a new cover
+// is decoded into another entry and swapped in by posting its descriptor
+static CoverEntry cache[COVER_CACHE_ENTRIES];
+static int shown = -1;
+static uint32_t useCount = 0;
+static uint8_t *fetchBuffer = NULL;       // Raw RGB565 or JPEG bytes as received
+static lv_color_t *decoded = NULL;        // Image at its own size, before scaling
+static HttpKeepAlive coverConn;
+static bool rgb565Unsupported = false;
+static QueueHandle_t coverQueue = NULL;
+
+// Keeps ArduinoJson's document for the JPEG fallback out of the internal heap
+struct SpiRamAllocator {
+  void *allocate(size_t size) {
+    return ps_malloc(size);
+  }
+  void deallocate(void *pointer) {
+    free(pointer);
+  }
+  void *reallocate(void *pointer, size_t size) {
+    return ps_realloc(pointer, size);
+  }
+};
+typedef BasicJsonDocument<SpiRamAllocator> SpiRamJsonDocument;
+
+struct JpegSource {
+  const uint8_t *data;
+  size_t len;
+  size_t pos;
+  int w;
+  int h;
+};
+
+static int lookup(const char *id) {
+  for (int i = 0; i < COVER_CACHE_ENTRIES; i++) {
+    if (cache[i].id[0] && strcmp(cache[i].id, id) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// Least recently shown entry, never the one on screen
+static int victim() {
+  int best = -1;
+  for (int i = 0; i < COVER_CACHE_ENTRIES; i++) {
+    if (i == shown) {
+      continue;
+    }
+    if (best < 0 || cache[i].lastUsed < cache[best].lastUsed) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+// Nearest neighbour scaling of decoded into the entry
+static void scaleInto(CoverEntry *entry, int w, int h) {
+  lv_color_t *dst = (lv_color_t *)entry->dsc.data;
+  for (int y = 0; y < COVER_ART_SIZE; y++) {
+    const lv_color_t *row = decoded + (y * h / COVER_ART_SIZE) * w;
+    for (int x = 0; x < COVER_ART_SIZE; x++) {
+      *dst++ = row[x * w / COVER_ART_SIZE];
+    }
+  }
+}
+
+// Send a GET on the kept-alive connection, once more on a new one if the server dropped it unanswered
+static int coverRequest(const char *path) {
+  for (int attempt = 0;; attempt++) {
+    if (coverConn.fd < 0 && !httpKeepAliveBegin(&coverConn, host.c_str(), COVER_TIMEOUT_MS)) {
+      coverConn.fd = -1;
+      return HTTP_KEEPALIVE_ERR_IO;
+    }
+    int status = httpKeepAliveSend(&coverConn, "GET", path) ? httpKeepAliveReceiveHead(&coverConn) : HTTP_KEEPALIVE_ERR_IO;
+    if (status != HTTP_KEEPALIVE_ERR_CLOSED || attempt > 0) {
+      return status;
+    }
+  }
+}
+
+/*
+ * Raw little endian RGB565 pixels of a square image, streamed into PSRAM.
+ * The side follows from the length, the server may pick any size up to COVER_MAX_SIDE.
+ * Returns the HTTP status, 200 once the entry holds the cover.
+ */
+static int fetchRgb565(CoverEntry *entry, const char *id) {
+  char path[sizeof(COVER_RGB565_PATH) + COVER_ID_LEN + 4];
+  snprintf(path, sizeof(path), "%s?id=%s", COVER_RGB565_PATH, id);
+  int status = coverRequest(path);
+  if (status != 200) {
+    return status;
+  }
+
+  size_t len = 0;
+  int n;
+  char extra;
+  while ((n = len < COVER_FETCH_LEN ? httpKeepAliveBodyRead(&coverConn, (char *)fetchBuffer + len, COVER_FETCH_LEN - len)
+                                    : httpKeepAliveBodyRead(&coverConn, &extra, 1)) > 0) {
+    if (len == COVER_FETCH_LEN) {
+      // The rest is skipped with the next response
+      Serial.println("RGB565 cover is too large");
+      return HTTP_KEEPALIVE_ERR_TOO_LARGE;
+    }
+    len += n;
+  }
+  if (n < 0) {
+    return n;
+  }
+  int side = 0;
+  while ((size_t)((side + 1) * (side + 1) * 2) <= len) {
+    side++;
+  }
+  if (side == 0 || (size_t)(side * side * 2) != len) {
+    Serial.printf("Unexpected RGB565 cover of %u bytes\n", (unsigned)len);
+    return HTTP_KEEPALIVE_ERR_PROTOCOL;
+  }
+
+  for (int i = 0; i < side * side; i++) {
+    uint16_t px = fetchBuffer[i * 2] | (fetchBuffer[i * 2 + 1] << 8);
+    decoded[i] = lv_color_make((px >> 11) << 3, ((px >> 5) & 0x3F) << 2, (px & 0x1F) << 3);
+  }
+  scaleInto(entry, side, side);
+  return status;
+}
+
+static size_t jpegInput(JDEC *jd, uint8_t *buf, size_t len) {
+  JpegSource *src = (JpegSource *)jd->device;
+  if (len > src->len - src->pos) {
+    len = src->len - src->pos;
+  }
+  if (buf) {
+    memcpy(buf, src->data + src->pos, len);
+  }
+  src->pos += len;
+  return len;
+}
+
+static int jpegOutput(JDEC *jd, void *bitmap, JRECT *rect) {
+  JpegSource *src = (JpegSource *)jd->device;
+  const uint8_t *rgb = (const uint8_t *)bitmap;
+  for (int y = rect->top; y <= rect->bottom; y++) {
+    for (int x = rect->left; x <= rect->right; x++, rgb += 3) {
+      if (x < src->w && y < src->h) {
+        decoded[y * src->w + x] = lv_color_make(rgb[0], rgb[1], rgb[2]);
+      }
+    }
+  }
+  return 1;
+}
+
+/*
+ * Fallback for servers without the RGB565 endpoint: the coverSmall JPEG of
+ * now-playing, decoded here so the render task never sees a JPEG.
+ */
+static int fetchJpeg(CoverEntry *entry, const char *id) {
+  int status = coverRequest("/spotify/now-playing");
+  if (status != 200) {
+    return status;
+  }
+
+  size_t len = 0;
+  {
+    StaticJsonDocument<JSON_OBJECT_SIZE(2)> filter;
+    filter["id"] = true;
+    filter["coverSmall"] = true;
+    SpiRamJsonDocument doc(COVER_JSON_LEN);
+    HttpKeepAliveReader reader = {&coverConn};
+    DeserializationError error = deserializeJson(doc, reader, DeserializationOption::Filter(filter));
+    const char *data = doc["coverSmall"] | "";
+    if (error || strcmp(doc["id"] | "", id) != 0) {
+      // The track changed since it was asked for, a newer request follows
+      return HTTP_KEEPALIVE_ERR_PROTOCOL;
+    }
+    // Skip the "data:image/jpeg;base64," prefix
+    const char *comma = strchr(data, ',');
+    data = comma ? comma + 1 : data;
+    if (mbedtls_base64_decode(fetchBuffer, COVER_FETCH_LEN, &len, (const unsigned char *)data, strlen(data)) != 0) {
+      Serial.println("Bad base64 in coverSmall");
+      return HTTP_KEEPALIVE_ERR_PROTOCOL;
+    }
+  }
+
+  static uint8_t pool[COVER_JPEG_POOL];
+  JpegSource src = {fetchBuffer, len, 0, 0, 0};
+  JDEC jd;
+  if (len == 0 || jd_prepare(&jd, jpegInput, pool, sizeof(pool), &src) != JDR_OK) {
+    Serial.println("Cover JPEG cannot be decoded");
+    return HTTP_KEEPALIVE_ERR_PROTOCOL;
+  }
+  // Let the decoder scale large covers down by up to 1/8
+  uint8_t scale = 0;
+  while (scale < 3 && ((jd.width >> scale) > COVER_MAX_SIDE || (jd.height >> scale) > COVER_MAX_SIDE)) {
+    scale++;
+  }
+  src.w = (jd.width + (1 << scale) - 1) >> scale;
+  src.h = (jd.height + (1 << scale) - 1) >> scale;
+  if (src.w > COVER_MAX_SIDE || src.h > COVER_MAX_SIDE) {
+    Serial.printf("Cover JPEG of %ux%u is too large\n", jd.width, jd.height);
+    return HTTP_KEEPALIVE_ERR_PROTOCOL;
+  }
+  memset(decoded, 0, src.w * src.h * sizeof(lv_color_t));
+  if (jd_decomp(&jd, jpegOutput, scale) != JDR_OK) {
+    Serial.println("Cover JPEG cannot be decoded");
+    return HTTP_KEEPALIVE_ERR_PROTOCOL;
+  }
+  scaleInto(entry, src.w, src.h);
+  return status;
+}
+
+static bool fetchCover(CoverEntry *entry, const char *id) {
+  if (!rgb565Unsupported) {
+    int status = fetchRgb565(entry, id);
+    if (status == 200) {
+      return true;
+    }
+    if (status != 404) {
+      return false;
+    }
+    Serial.println("Server has no RGB565 covers, decoding its JPEG covers instead");
+    rgb565Unsupported = true;
+  }
+  return fetchJpeg(entry, id) == 200;
+}
+
+// The UI update queue may be full, it drains with the next frame. Posts are retried
+// until it takes them, or given up once a newer request makes them pointless
+static bool postShown(int index) {
+  bool posted = postLvglImageSrc(cover_art, &cache[index].dsc);
+  while (!posted && uxQueueMessagesWaiting(coverQueue) == 0) {
+    vTaskDelay(pdMS_TO_TICKS(COVER_POST_RETRY_MS));
+    posted = postLvglImageSrc(cover_art, &cache[index].dsc);
+  }
+  return posted;
+}
+
+static bool postHidden(bool hidden) {
+  bool posted = postLvglFlag(cover_art, LV_OBJ_FLAG_HIDDEN, hidden);
+  while (!posted && uxQueueMessagesWaiting(coverQueue) == 0) {
+    vTaskDelay(pdMS_TO_TICKS(COVER_POST_RETRY_MS));
+    posted = postLvglFlag(cover_art, LV_OBJ_FLAG_HIDDEN, hidden);
+  }
+  return posted;
+}
+
+// The entry on screen may only be reused once the hide is queued
+static void hideCover() {
+  if (postHidden(true)) {
+    shown = -1;
+  }
+}
+
+static void coverTask(void *args) {
+  CoverRequest request;
+  for (;;) {
+    xQueueReceive(coverQueue, &request, portMAX_DELAY);
+    if (request.id[0] == '\0' || WiFi.status() != WL_CONNECTED || host.length() == 0) {
+      hideCover();
+      continue;
+    }
+
+    int index = lookup(request.id);
+    if (index < 0) {
+      index = victim();
+      CoverEntry *entry = &cache[index];
+      entry->id[0] = '\0';
+      bool ok = fetchCover(entry, request.id);
+      if (uxQueueMessagesWaiting(coverQueue) > 0) {
+        // Skipped on already, the cover may belong to the next track
+        continue;
+      }
+      if (!ok) {
+        Serial.println("Cover art not available");
+        hideCover();
+        continue;
+      }
+      strlcpy(entry->id, request.id, sizeof(entry->id));
+    }
+
+    // The render task picks up both changes before its next frame
+    cache[index].lastUsed = ++useCount;
+    if (index != shown) {
+      if (!postShown(index)) {
+        // Skipped on, the old cover stays on screen and keeps its entry
+        continue;
+      }
+      shown = index;
+    }
+    // Given up only for a newer request, which shows or hides the cover again
+    postHidden(false);
+  }
+}
+
+void initCoverArt() {
+  uint8_t *pixels = (uint8_t *)ps_malloc(COVER_CACHE_ENTRIES * COVER_ART_SIZE * COVER_ART_SIZE * sizeof(lv_color_t));
+  fetchBuffer = (uint8_t *)ps_malloc(COVER_FETCH_LEN);
+  decoded = (lv_color_t *)ps_malloc(COVER_MAX_SIDE * COVER_MAX_SIDE * sizeof(lv_color_t));
+  coverQueue = xQueueCreate(1, sizeof(CoverRequest));
+  if (!pixels || !fetchBuffer || !decoded || !coverQueue) {
+    Serial.println("Failed to allocate the cover art cache.");
+    return;
+  }
+
+  for (int i = 0; i < COVER_CACHE_ENTRIES; i++) {
+    lv_img_dsc_t *dsc = &cache[i].dsc;
+    dsc->header.always_zero = 0;
+    dsc->header.cf = LV_IMG_CF_TRUE_COLOR;
+    dsc->header.w = COVER_ART_SIZE;
+    dsc->header.h = COVER_ART_SIZE;
+    dsc->data_size = COVER_ART_SIZE * COVER_ART_SIZE * sizeof(lv_color_t);
+    dsc->data = pixels + i * dsc->data_size;
+  }
+  coverConn.fd = -1;
+
+  // Decoding runs next to the Spotify tasks, away from the render task's core
+  if (xTaskCreatePinnedToCore(coverTask, "cover", COVER_TASK_STACK, NULL, 1, NULL, 0) != pdPASS) {
+    Serial.println("Failed to start the cover art task.");
+    vQueueDelete(coverQueue);
+    coverQueue = NULL;
+  }
+}
+
+void updateCoverArt(const char *trackId) {
+  if (!coverQueue) {
+    return;
+  }
+  // A newer track replaces one that is still waiting
+  CoverRequest request;
+  strlcpy(request.id, trackId ? trackId : "", sizeof(request.id));
+  xQueueOverwrite(coverQueue, &request);
+}
@@ -0,0 +1,29 @@
+/**
+ * @file      cover.h
+ * @brief     Album cover art, fetched and decoded on its own task
+ */
+
+#ifndef COVER_H
+#define COVER_H
+
+#include "config.h"
+
+#define COVER_ART_SIZE 78       // Inside the 1 px border of the 80x80 cover frame
+#define COVER_CACHE_ENTRIES 8   // Covers kept in PSRAM, skipping back and forth is free
+
+/**
+ * @brief Allocate the cover cache and start the cover task
+ */
+void initCoverArt();
+
+/**
+ * @brief Show the cover of a track, fetched from the server unless it is cached
+ * @note Returns right away, only the latest track asked for is fetched.
+ *       An empty id hides the cover
+ */
+void updateCoverArt(const char *trackId);
+
+// Cover art image inside cover_img
+extern lv_obj_t *cover_art;
+
+#endif // COVER_H
@@ -6,6 +6,8 @@
 #include "display.h"
 #include "spotify.h"
 #include "discord.h"
+#include "cover.h"
+#include "playback.h"
 
 // Global variables
 lv_obj_t *info_container = NULL;
@@ -28,6 +30,9 @@ bool initDisplay() {
   if (result) {
     // Initialize LVGL helper
     beginLvglHelper(amoled);
+
+    // Shadows of the info panel and Discord buttons are blurred once, not every frame
+    beginLvglShadowCache();
     
     // Set display brightness to medium level (adjust as needed)
     amoled.setBrightness(128); // 0-255
@@ -44,19 +49,15 @@ void setupUI() {
   lv_obj_t *main_screen = lv_scr_act();
   
   // === Time and Date (Left Side) ===
-  // Create time label with large font
-  time_label = lv_label_create(main_screen);
-  lv_label_set_text(time_label, "00:00");
+  // Create time label with large font, only the digits that change are redrawn
+  time_label = createLvglDigitLabel(main_screen, &lv_font_montserrat_48, lv_color_hex(TEXT_COLOR), lv_color_hex(DARK_BG_COLOR));
+  setLvglDigitLabelText(time_label, "00:00");
   lv_obj_align(time_label, LV_ALIGN_LEFT_MID, 20, -20);
-  lv_obj_set_style_text_font(time_label, &lv_font_montserrat_48, 0);
-  lv_obj_set_style_text_color(time_label, lv_color_hex(TEXT_COLOR), 0);
   
   // Create date label below time
-  date_label = lv_label_create(main_screen);
-  lv_label_set_text(date_label, "00.00.00");
+  date_label = createLvglDigitLabel(main_screen, &lv_font_montserrat_20, lv_color_hex(TEXT_SECONDARY), lv_color_hex(DARK_BG_COLOR));
+  setLvglDigitLabelText(date_label, "00.00.00");
   lv_obj_align(date_label, LV_ALIGN_LEFT_MID, 20, 30);
-  lv_obj_set_style_text_font(date_label, &lv_font_montserrat_20, 0);
-  lv_obj_set_style_text_color(date_label, lv_color_hex(TEXT_SECONDARY), 0);
   
   // === Spotify Controls (Right Side) - Now wider ===
   // Use full right half of screen
@@ -71,6 +72,18 @@ void setupUI() {
   lv_obj_set_style_border_width(cover_img, 1, 0);
   lv_obj_set_style_border_color(cover_img, lv_color_hex(ACCENT_GREEN), 0);
   lv_obj_set_style_radius(cover_img, 5, 0);
+  lv_obj_set_style_pad_all(cover_img, 0, 0);
+  lv_obj_clear_flag(cover_img, LV_OBJ_FLAG_SCROLLABLE);
+
+  // Cover art, hidden until the cover task has the first one
+  cover_art = lv_img_create(cover_img);
+  lv_obj_center(cover_art);
+  lv_obj_add_flag(cover_art, LV_OBJ_FLAG_HIDDEN);
+
+  // Playback progress under the cover, advanced every frame between now-playing updates
+  progress_bar = createLvglProgressBar(main_screen, 160, 4, lv_color_hex(ACCENT_GREEN), lv_color_hex(DARK_ACCENT_COLOR));
+  lv_obj_align(progress_bar, LV_ALIGN_TOP_RIGHT, -spotify_right_margin - (spotify_width - 160) / 2, 104);
+  initPlaybackBar(progress_bar);
   
   // Create song title label
   song_title_label = lv_label_create(main_screen);
@@ -123,7 +136,7 @@ void setupUI() {
   lv_obj_set_style_shadow_width(play_btn, 0, 0);
   lv_obj_set_style_radius(play_btn, 22, 0); // Make it round
   
-  lv_obj_t *play_label = lv_label_create(play_btn);
+  play_label = lv_label_create(play_btn);
   lv_label_set_text(play_label, LV_SYMBOL_PLAY);
   lv_obj_center(play_label);
   lv_obj_set_style_text_color(play_label, lv_color_hex(ACCENT_GREEN), 0);
@@ -244,11 +257,7 @@ void setupUI() {
     static uint32_t checkMs = 0;
     if (millis() > checkMs) {
       showing_info = !showing_info;
-      if (showing_info) {
-        lv_obj_clear_flag(info_container, LV_OBJ_FLAG_HIDDEN);
-      } else {
-        lv_obj_add_flag(info_container, LV_OBJ_FLAG_HIDDEN);
-      }
+      postLvglFlag(info_container, LV_OBJ_FLAG_HIDDEN, !showing_info);
     }
     checkMs = millis() + 200;
   }, NULL);
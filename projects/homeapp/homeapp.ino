@@ -15,10 +15,6 @@
 
 
 
-// Variables for Spotify update timing
-unsigned long lastSpotifyUpdate = 0;
-const long spotifyUpdateInterval = 5000; // Update every 5 seconds
-
 // Variables for Discord update timing
 unsigned long lastDiscordUpdate = 0;
 const long discordUpdateInterval = 10000; // Update every 10 seconds
@@ -38,6 +34,14 @@ void setup() {
   
   // Setup UI before initializing network connections
   setupUI();
+
+  // From here on lvgl runs on its own task, the modules below only post updates
+  if (!beginLvglRuntime()) {
+    Serial.println("LVGL runtime start failed!");
+    while (1) {
+      delay(1000);
+    }
+  }
   
   // Now initialize WiFi (after UI is ready)
   initWiFi();
@@ -61,30 +65,15 @@ void loop() {
   // Check WiFi connection status periodically
   checkWiFiStatus();
   
-  // Update Spotify information periodically
-  updateSpotifyStatus();
-  
+  // Spotify polls and handles button presses on its own task, see initSpotify()
+
   // Update Discord status periodically
   // updateDiscordState();
   
-  // Handle LVGL tasks
-  lv_task_handler();
+  // LVGL runs on its own task, the network calls above can block without freezing the UI
   delay(5);
 }
 
-void updateSpotifyStatus() {
-  // Only update every spotifyUpdateInterval ms
-  unsigned long currentMillis = millis();
-  if (currentMillis - lastSpotifyUpdate >= spotifyUpdateInterval) {
-    lastSpotifyUpdate = currentMillis;
-    
-    // Only check Spotify if WiFi is connected
-    if (WiFi.status() == WL_CONNECTED) {
-      updateNowPlaying();
-    }
-  }
-}
-
 void updateDiscordState() {
   // Only update every discordUpdateInterval ms
   unsigned long currentMillis = millis();
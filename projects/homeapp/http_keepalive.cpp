@@ -0,0 +1,476 @@
+/**
+ * @file      http_keepalive.cpp
+ * @brief     Persistent HTTP/1.1 connection with request pipelining
+ */
+
+#include "http_keepalive.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+
+#define HTTP_KEEPALIVE_LINE_LEN 256
+
+// A write to a connection the server closed must fail, not raise SIGPIPE
+#ifdef MSG_NOSIGNAL
+#define HTTP_KEEPALIVE_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define HTTP_KEEPALIVE_SEND_FLAGS 0
+#endif
+
+static void setTimeout(int fd, uint32_t timeoutMs) {
+  struct timeval tv;
+  tv.tv_sec = timeoutMs / 1000;
+  tv.tv_usec = (timeoutMs % 1000) * 1000;
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+// connect() with a timeout, a blocking connect to a missing host takes far too long
+static bool connectTimeout(int fd, const struct sockaddr *addr, socklen_t addrLen, uint32_t timeoutMs) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+  int rc = connect(fd, addr, addrLen);
+  if (rc < 0 && errno == EINPROGRESS) {
+    fd_set wfds;
+    FD_ZERO(&wfds);
+    FD_SET(fd, &wfds);
+    struct timeval tv;
+    tv.tv_sec = timeoutMs / 1000;
+    tv.tv_usec = (timeoutMs % 1000) * 1000;
+    rc = -1;
+    if (select(fd + 1, NULL, &wfds, NULL, &tv) > 0) {
+      int err = 0;
+      socklen_t len = sizeof(err);
+      getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len);
+      rc = err ? -1 : 0;
+    }
+  }
+  fcntl(fd, F_SETFL, flags);
+  return rc == 0;
+}
+
+static bool openConnection(HttpKeepAlive *conn) {
+  char port[8];
+  snprintf(port, sizeof(port), "%u", conn->port);
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  struct addrinfo *res = NULL;
+  if (getaddrinfo(conn->host, port, &hints, &res) != 0 || !res) {
+    return false;
+  }
+
+  int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+  if (fd >= 0 && !connectTimeout(fd, res->ai_addr, res->ai_addrlen, conn->timeoutMs)) {
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(res);
+  if (fd < 0) {
+    return false;
+  }
+
+  // Pipelined requests are small, send each one right away
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  setTimeout(fd, conn->timeoutMs);
+
+  conn->fd = fd;
+  conn->reused = false;
+  conn->peerClosed = false;
+  conn->rxPos = conn->rxLen = 0;
+  conn->connects++;
+  return true;
+}
+
+static bool sendAll(int fd, const char *data, size_t len) {
+  while (len) {
+    ssize_t n = send(fd, data, len, HTTP_KEEPALIVE_SEND_FLAGS);
+    if (n <= 0) {
+      return false;
+    }
+    data += n;
+    len -= n;
+  }
+  return true;
+}
+
+static bool isPeerClose(ssize_t n) {
+  return n == 0 || (n < 0 && (errno == ECONNRESET || errno == EPIPE || errno == ENOTCONN));
+}
+
+// Next received byte, -1 when the connection is closed or times out
+static int readByte(HttpKeepAlive *conn) {
+  if (conn->rxPos == conn->rxLen) {
+    ssize_t n = recv(conn->fd, conn->rx, sizeof(conn->rx), 0);
+    if (n <= 0) {
+      conn->peerClosed = isPeerClose(n);
+      return -1;
+    }
+    conn->rxPos = 0;
+    conn->rxLen = n;
+  }
+  return (uint8_t)conn->rx[conn->rxPos++];
+}
+
+// One header line without the CRLF, longer lines are cut
+static bool readLine(HttpKeepAlive *conn, char *line, size_t size) {
+  size_t len = 0;
+  for (;;) {
+    int c = readByte(conn);
+    if (c < 0) {
+      return false;
+    }
+    if (c == '\n') {
+      break;
+    }
+    if (c != '\r' && len < size - 1) {
+      line[len++] = c;
+    }
+  }
+  line[len] = '\0';
+  return true;
+}
+
+static bool hasToken(const char *value, const char *token) {
+  size_t len = strlen(token);
+  for (; *value; value++) {
+    if (strncasecmp(value, token, len) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool httpKeepAliveBegin(HttpKeepAlive *conn, const char *url, uint32_t timeoutMs) {
+  memset(conn, 0, sizeof(HttpKeepAlive));
+  conn->fd = -1;
+  conn->timeoutMs = timeoutMs;
+  conn->port = 80;
+
+  if (strncmp(url, "http://", 7) == 0) {
+    url += 7;
+  }
+  size_t len = strcspn(url, ":/");
+  if (len == 0 || len >= sizeof(conn->host)) {
+    return false;
+  }
+  memcpy(conn->host, url, len);
+  conn->host[len] = '\0';
+  if (url[len] == ':') {
+    int port = atoi(url + len + 1);
+    if (port <= 0 || port > 65535) {
+      return false;
+    }
+    conn->port = port;
+  }
+  return true;
+}
+
+// True if an idle connection was closed by the server, nothing is expected on it
+static bool idleClosed(HttpKeepAlive *conn) {
+  if (conn->bodyOpen || conn->rxPos != conn->rxLen) {
+    return false;
+  }
+  char c;
+  ssize_t n = recv(conn->fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+  return n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK);
+}
+
+bool httpKeepAliveSend(HttpKeepAlive *conn, const char *method, const char *path) {
+  if (conn->fd >= 0 && conn->reused && idleClosed(conn)) {
+    httpKeepAliveClose(conn);
+  }
+  if (conn->fd < 0 && !openConnection(conn)) {
+    return false;
+  }
+  char request[HTTP_KEEPALIVE_LINE_LEN];
+  int len = snprintf(request, sizeof(request),
+                     "%s %s HTTP/1.1\r\n"
+                     "Host: %s:%u\r\n"
+                     "Connection: keep-alive\r\n"
+                     "Content-Length: 0\r\n"
+                     "\r\n",
+                     method, path, conn->host, conn->port);
+  if (len <= 0 || len >= (int)sizeof(request) || !sendAll(conn->fd, request, len)) {
+    httpKeepAliveClose(conn);
+    return false;
+  }
+  conn->requests++;
+  return true;
+}
+
+// Status line and headers of a response
+struct HttpHead {
+  int status;
+  long contentLength;
+  bool chunked;
+  bool closeAfter;
+  char contentType[48];
+};
+
+// Returns the status code, or an error after closing the connection
+static int readHead(HttpKeepAlive *conn, HttpHead *head) {
+  char line[HTTP_KEEPALIVE_LINE_LEN];
+  memset(head, 0, sizeof(HttpHead));
+  head->contentLength = -1;
+  if (conn->fd < 0) {
+    // Pipelined requests after a response that ended the connection
+    return conn->peerClosed ? HTTP_KEEPALIVE_ERR_CLOSED : HTTP_KEEPALIVE_ERR_IO;
+  }
+  // Tell a server that dropped the request from one that is slow to answer
+  if (readByte(conn) < 0) {
+    bool closed = conn->peerClosed;
+    httpKeepAliveClose(conn);
+    conn->peerClosed = closed;
+    return closed ? HTTP_KEEPALIVE_ERR_CLOSED : HTTP_KEEPALIVE_ERR_IO;
+  }
+  conn->rxPos--;
+  if (!readLine(conn, line, sizeof(line))) {
+    httpKeepAliveClose(conn);
+    return HTTP_KEEPALIVE_ERR_IO;
+  }
+  if (sscanf(line, "HTTP/1.%*d %d", &head->status) != 1) {
+    httpKeepAliveClose(conn);
+    return HTTP_KEEPALIVE_ERR_PROTOCOL;
+  }
+
+  head->closeAfter = strncmp(line, "HTTP/1.0", 8) == 0;
+  for (;;) {
+    if (!readLine(conn, line, sizeof(line))) {
+      httpKeepAliveClose(conn);
+      return HTTP_KEEPALIVE_ERR_IO;
+    }
+    if (line[0] == '\0') {
+      break;
+    }
+    if (strncasecmp(line, "Content-Length:", 15) == 0) {
+      head->contentLength = atol(line + 15);
+    } else if (strncasecmp(line, "Transfer-Encoding:", 18) == 0) {
+      head->chunked = hasToken(line + 18, "chunked");
+    } else if (strncasecmp(line, "Connection:", 11) == 0) {
+      head->closeAfter = hasToken(line + 11, "close");
+    } else if (strncasecmp(line, "Content-Type:", 13) == 0) {
+      const char *value = line + 13 + strspn(line + 13, " ");
+      strncpy(head->contentType, value, sizeof(head->contentType) - 1);
+    }
+  }
+  return head->status;
+}
+
+// The body has been read, the connection is ready for the next response
+static int endBody(HttpKeepAlive *conn) {
+  conn->bodyOpen = false;
+  conn->reused = true;
+  if (conn->closeAfter) {
+    httpKeepAliveClose(conn);
+    conn->peerClosed = true;
+  }
+  return 0;
+}
+
+static int failBody(HttpKeepAlive *conn) {
+  conn->bodyOpen = false;
+  httpKeepAliveClose(conn);
+  return HTTP_KEEPALIVE_ERR_IO;
+}
+
+int httpKeepAliveReceiveHead(HttpKeepAlive *conn) {
+  // Skip what was not read of the previous body
+  char skip[64];
+  int n;
+  while ((n = httpKeepAliveBodyRead(conn, skip, sizeof(skip))) > 0) {
+  }
+  if (n < 0) {
+    return n;
+  }
+
+  HttpHead head;
+  int status = readHead(conn, &head);
+  if (status < 0) {
+    return status;
+  }
+  conn->bodyOpen = true;
+  conn->bodyChunked = false;
+  conn->bodyCrlf = false;
+  conn->closeAfter = head.closeAfter;
+  if (status == 204 || status == 304 || (status >= 100 && status < 200)) {
+    // No body
+    conn->bodyLeft = 0;
+  } else if (head.chunked) {
+    conn->bodyChunked = true;
+    conn->bodyLeft = 0;
+  } else if (head.contentLength >= 0) {
+    conn->bodyLeft = head.contentLength;
+  } else {
+    // Delimited by the end of the connection
+    conn->bodyLeft = -1;
+    conn->closeAfter = true;
+  }
+  return status;
+}
+
+int httpKeepAliveBodyRead(HttpKeepAlive *conn, char *buf, size_t size) {
+  if (!conn->bodyOpen) {
+    return 0;
+  }
+  if (conn->fd < 0) {
+    return failBody(conn);
+  }
+  if (conn->bodyChunked && conn->bodyLeft == 0) {
+    char line[HTTP_KEEPALIVE_LINE_LEN];
+    // The CRLF after the previous chunk, then the size of the next one
+    if ((conn->bodyCrlf && !readLine(conn, line, sizeof(line))) || !readLine(conn, line, sizeof(line))) {
+      return failBody(conn);
+    }
+    conn->bodyLeft = strtol(line, NULL, 16);
+    conn->bodyCrlf = true;
+    if (conn->bodyLeft <= 0) {
+      // Last chunk, trailers end with an empty line
+      bool ok;
+      while ((ok = readLine(conn, line, sizeof(line))) && line[0] != '\0') {
+      }
+      return ok ? endBody(conn) : failBody(conn);
+    }
+  }
+  if (conn->bodyLeft == 0) {
+    return endBody(conn);
+  }
+
+  // Wait for the first byte, then hand out what has already arrived
+  int c = readByte(conn);
+  if (c < 0) {
+    return conn->bodyLeft < 0 ? endBody(conn) : failBody(conn);
+  }
+  size_t n = 0;
+  buf[n++] = c;
+  size_t avail = conn->rxLen - conn->rxPos;
+  size_t want = size - n;
+  if (conn->bodyLeft > 0 && want > (size_t)conn->bodyLeft - 1) {
+    want = conn->bodyLeft - 1;
+  }
+  if (want > avail) {
+    want = avail;
+  }
+  memcpy(buf + n, conn->rx + conn->rxPos, want);
+  conn->rxPos += want;
+  n += want;
+  if (conn->bodyLeft > 0) {
+    conn->bodyLeft -= n;
+  }
+  return n;
+}
+
+int HttpKeepAliveReader::read() {
+  char c;
+  return httpKeepAliveBodyRead(conn, &c, 1) == 1 ? (uint8_t)c : -1;
+}
+
+size_t HttpKeepAliveReader::readBytes(char *buf, size_t len) {
+  size_t n = 0;
+  while (n < len) {
+    int r = httpKeepAliveBodyRead(conn, buf + n, len - n);
+    if (r <= 0) {
+      break;
+    }
+    n += r;
+  }
+  return n;
+}
+
+int httpKeepAliveReceive(HttpKeepAlive *conn, char *body, size_t size, size_t *length) {
+  size_t bodyLen = 0;
+  body[0] = '\0';
+  if (length) {
+    *length = 0;
+  }
+
+  int status = httpKeepAliveReceiveHead(conn);
+  if (status < 0) {
+    return status;
+  }
+
+  // Keep what fits, the rest is read and dropped
+  char skip[64];
+  bool overflow = false;
+  int n;
+  for (;;) {
+    bool fits = bodyLen < size - 1;
+    n = httpKeepAliveBodyRead(conn, fits ? body + bodyLen : skip, fits ? size - 1 - bodyLen : sizeof(skip));
+    if (n <= 0) {
+      break;
+    }
+    if (fits) {
+      bodyLen += n;
+    } else {
+      overflow = true;
+    }
+  }
+  body[bodyLen] = '\0';
+  if (length) {
+    *length = bodyLen;
+  }
+  if (n < 0) {
+    return HTTP_KEEPALIVE_ERR_IO;
+  }
+  return overflow ? HTTP_KEEPALIVE_ERR_TOO_LARGE : status;
+}
+
+int httpKeepAliveStreamOpen(HttpKeepAlive *conn, const char *path, const char *accept, uint32_t idleMs) {
+  // The stream keeps the connection for itself
+  httpKeepAliveClose(conn);
+  if (!openConnection(conn)) {
+    return HTTP_KEEPALIVE_ERR_IO;
+  }
+  char request[HTTP_KEEPALIVE_LINE_LEN];
+  int len = snprintf(request, sizeof(request),
+                     "GET %s HTTP/1.1\r\n"
+                     "Host: %s:%u\r\n"
+                     "Accept: %s\r\n"
+                     "Cache-Control: no-cache\r\n"
+                     "\r\n",
+                     path, conn->host, conn->port, accept);
+  if (len <= 0 || len >= (int)sizeof(request) || !sendAll(conn->fd, request, len)) {
+    httpKeepAliveClose(conn);
+    return HTTP_KEEPALIVE_ERR_IO;
+  }
+  conn->requests++;
+
+  HttpHead head;
+  int status = readHead(conn, &head);
+  if (status < 0) {
+    return status;
+  }
+  if (status != 200 || strncasecmp(head.contentType, accept, strlen(accept)) != 0) {
+    // Not streamed, e.g. an older server answering 404
+    httpKeepAliveClose(conn);
+    return status == 200 ? HTTP_KEEPALIVE_ERR_PROTOCOL : status;
+  }
+  conn->bodyOpen = true;
+  conn->bodyChunked = head.chunked;
+  conn->bodyCrlf = false;
+  conn->bodyLeft = head.chunked ? 0 : head.contentLength;
+  conn->closeAfter = true;
+  setTimeout(conn->fd, idleMs);
+  return status;
+}
+
+void httpKeepAliveClose(HttpKeepAlive *conn) {
+  if (conn->fd >= 0) {
+    close(conn->fd);
+    conn->fd = -1;
+  }
+  conn->rxPos = conn->rxLen = 0;
+  conn->bodyOpen = false;
+  conn->peerClosed = false;
+}
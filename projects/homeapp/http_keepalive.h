@@ -0,0 +1,111 @@
+/**
+ * @file      http_keepalive.h
+ * @brief     Persistent HTTP/1.1 connection with request pipelining
+ *
+ * Built on plain BSD sockets, so the same code runs on the ESP32 (lwIP) and on
+ * Linux, where it can be tried against a local stand-in for the API server.
+ */
+
+#ifndef HTTP_KEEPALIVE_H
+#define HTTP_KEEPALIVE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HTTP_KEEPALIVE_HOST_LEN 64
+#define HTTP_KEEPALIVE_RX_LEN 1024
+
+// Negative results of httpKeepAliveReceive()
+#define HTTP_KEEPALIVE_ERR_IO -1        // Connection lost or timed out, it has been closed
+#define HTTP_KEEPALIVE_ERR_PROTOCOL -2  // Not an HTTP response, the connection has been closed
+#define HTTP_KEEPALIVE_ERR_TOO_LARGE -3 // Body did not fit and was skipped, the connection is still usable
+#define HTTP_KEEPALIVE_ERR_CLOSED -4    // Server closed before any byte of the response, the connection has been closed
+
+struct HttpKeepAlive {
+  int fd;
+  char host[HTTP_KEEPALIVE_HOST_LEN];
+  uint16_t port;
+  uint32_t timeoutMs;
+  bool reused;                      // A response was already read on this connection
+  bool peerClosed;                  // The last failed read saw the end of the connection or a reset
+  char rx[HTTP_KEEPALIVE_RX_LEN];   // Bytes received but not consumed yet
+  size_t rxPos;
+  size_t rxLen;
+  bool bodyOpen;                    // Body of the last response not read to the end yet
+  bool bodyChunked;
+  bool bodyCrlf;                    // A chunk was read, its CRLF comes before the next size
+  bool closeAfter;                  // The server closes the connection after this body
+  long bodyLeft;                    // Bytes left in the body or chunk, -1 until the server closes
+  uint32_t connects;
+  uint32_t requests;
+};
+
+/**
+ * @brief Set up a connection to "http://host[:port]", nothing is opened yet
+ * @return false if the URL cannot be parsed
+ */
+bool httpKeepAliveBegin(HttpKeepAlive *conn, const char *url, uint32_t timeoutMs);
+
+/**
+ * @brief Queue a request without a body, connecting first if needed
+ * @note Several requests can be sent before their responses are read,
+ *       the responses arrive in the same order. An idle connection the
+ *       server already closed is replaced by a new one
+ * @return false if the connection cannot be opened or written
+ */
+bool httpKeepAliveSend(HttpKeepAlive *conn, const char *method, const char *path);
+
+/**
+ * @brief Read the next response
+ * @param body Receives the body, always NUL terminated
+ * @param size Size of body including the terminator
+ * @param length Receives the body length, may be NULL
+ * @return HTTP status code, or one of the HTTP_KEEPALIVE_ERR codes
+ */
+int httpKeepAliveReceive(HttpKeepAlive *conn, char *body, size_t size, size_t *length);
+
+/**
+ * @brief Read the status line and headers of the next response
+ * @note The body is then read with httpKeepAliveBodyRead(), whatever is left
+ *       of it is skipped when the next response is received.
+ *       Only HTTP_KEEPALIVE_ERR_CLOSED tells that the server dropped the
+ *       connection without answering, a timeout is HTTP_KEEPALIVE_ERR_IO
+ * @return HTTP status code, or one of the HTTP_KEEPALIVE_ERR codes
+ */
+int httpKeepAliveReceiveHead(HttpKeepAlive *conn);
+
+/**
+ * @brief Read the body of the response as it arrives
+ * @return Number of bytes, 0 at the end of the body,
+ *         or HTTP_KEEPALIVE_ERR_IO after closing the connection
+ */
+int httpKeepAliveBodyRead(HttpKeepAlive *conn, char *buf, size_t size);
+
+/**
+ * @brief Reads the body of the current response as a byte stream,
+ *        with the read()/readBytes() pair ArduinoJson takes as input
+ */
+struct HttpKeepAliveReader {
+  HttpKeepAlive *conn;
+
+  int read();
+  size_t readBytes(char *buf, size_t len);
+};
+
+/**
+ * @brief Open a streamed response, such as Server-Sent Events
+ * @note The connection is used for the stream only, its body is read with
+ *       httpKeepAliveBodyRead() until the stream ends
+ * @param accept Media type asked for, the response must have it
+ * @param idleMs The stream is considered dead after this long without data
+ * @return 200, another HTTP status if the server does not stream the path,
+ *         or one of the HTTP_KEEPALIVE_ERR codes
+ */
+int httpKeepAliveStreamOpen(HttpKeepAlive *conn, const char *path, const char *accept, uint32_t idleMs);
+
+/**
+ * @brief Close the connection, the next request opens a new one
+ */
+void httpKeepAliveClose(HttpKeepAlive *conn);
+
+#endif // HTTP_KEEPALIVE_H
@@ -0,0 +1,74 @@
+/**
+ * @file      playback.cpp
+ * @brief     Playback clock, extrapolates the track position between samples
+ */
+
+#include "playback.h"
+
+struct PlaybackClock {
+  long base;              // Position at sampleTime
+  long slew;              // Drift still to be worked off, fades out over PLAYBACK_SLEW_MS
+  uint32_t duration;
+  uint32_t sampleTime;
+  bool playing;
+};
+
+// Written by the Spotify tasks, read by the render task every frame
+static PlaybackClock playbackClock;
+static portMUX_TYPE playbackLock = portMUX_INITIALIZER_UNLOCKED;
+
+static long extrapolate(const PlaybackClock *clock, uint32_t now) {
+  long elapsed = clock->playing ? (long)(now - clock->sampleTime) : 0;
+  long progress = clock->base + elapsed;
+  if (elapsed < PLAYBACK_SLEW_MS) {
+    progress += clock->slew * (PLAYBACK_SLEW_MS - elapsed) / PLAYBACK_SLEW_MS;
+  }
+  if (progress < 0) {
+    return 0;
+  }
+  return clock->duration && progress > (long)clock->duration ? clock->duration : progress;
+}
+
+void updatePlaybackClock(long progressMs, long durationMs, bool playing) {
+  portENTER_CRITICAL(&playbackLock);
+  uint32_t now = millis();
+  long shown = extrapolate(&playbackClock, now);
+  if (durationMs >= 0) {
+    playbackClock.duration = durationMs;
+  }
+  if (progressMs >= 0) {
+    // Small drift is blended in so the bar does not twitch, seeks and pauses jump
+    long drift = progressMs - shown;
+    bool jump = drift > PLAYBACK_RESYNC_MS || drift < -PLAYBACK_RESYNC_MS || !playing;
+    playbackClock.base = progressMs;
+    playbackClock.slew = jump ? 0 : -drift;
+  } else {
+    // Play or pause without a position, carry on from where the bar is
+    playbackClock.base = shown;
+    playbackClock.slew = 0;
+  }
+  playbackClock.playing = playing;
+  playbackClock.sampleTime = now;
+  portEXIT_CRITICAL(&playbackLock);
+}
+
+uint32_t getPlaybackProgress(uint32_t *durationMs) {
+  portENTER_CRITICAL(&playbackLock);
+  PlaybackClock clock = playbackClock;
+  portEXIT_CRITICAL(&playbackLock);
+  if (durationMs) {
+    *durationMs = clock.duration;
+  }
+  return extrapolate(&clock, millis());
+}
+
+static void playbackTimer(lv_timer_t *timer) {
+  // Only redraws when the end of the bar moves to another column
+  uint32_t duration;
+  uint32_t progress = getPlaybackProgress(&duration);
+  setLvglProgressBarValue((lv_obj_t *)timer->user_data, progress, duration);
+}
+
+void initPlaybackBar(lv_obj_t *bar) {
+  lv_timer_create(playbackTimer, LV_DISP_DEF_REFR_PERIOD, bar);
+}
@@ -0,0 +1,34 @@
+/**
+ * @file      playback.h
+ * @brief     Playback clock, extrapolates the track position between samples
+ */
+
+#ifndef PLAYBACK_H
+#define PLAYBACK_H
+
+#include "config.h"
+
+#define PLAYBACK_RESYNC_MS 1500   // A sample further off than this is a seek, the bar jumps
+#define PLAYBACK_SLEW_MS 1000     // Smaller drift is worked off over this long
+
+/**
+ * @brief Drive the progress bar from the playback clock on the render task
+ * @note Call from setupUI(), before the lvgl runtime starts
+ */
+void initPlaybackBar(lv_obj_t *bar);
+
+/**
+ * @brief Feed a new sample, from any task
+ * @param progressMs Position in the track, -1 if the update has none
+ * @param durationMs Length of the track, -1 if the update has none
+ * @param playing Whether the position advances
+ */
+void updatePlaybackClock(long progressMs, long durationMs, bool playing);
+
+/**
+ * @brief Position extrapolated to now
+ * @param durationMs Receives the length of the track, 0 while unknown
+ */
+uint32_t getPlaybackProgress(uint32_t *durationMs);
+
+#endif // PLAYBACK_H
@@ -4,11 +4,38 @@
  */
 
 #include "spotify.h"
+#include "http_keepalive.h"
+#include "sse_parser.h"
+#include "cover.h"
+#include "playback.h"
 #include <lvgl.h>
 #include <WiFiUdp.h>
-
-
-static StaticJsonDocument<16384> jsonBuffer;
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+
+#define SPOTIFY_QUEUE_LEN 8
+#define SPOTIFY_TASK_STACK 8192
+#define SPOTIFY_TIMEOUT_MS 3000
+#define SPOTIFY_REFRESH_DELAY 500 // Poll this long after a button press
+#define SPOTIFY_PUSH_PATH "/spotify/events"
+#define SPOTIFY_PUSH_IDLE_MS 45000 // The server sends a keep-alive comment well within this
+#define SPOTIFY_PUSH_BACKOFF_MIN 1000
+#define SPOTIFY_PUSH_BACKOFF_MAX 60000
+#define SPOTIFY_PUSH_RETRY_UNSUPPORTED 300000 // Server without push support, ask again later
+
+
+// Responses are parsed as they arrive and keep only the fields of responseFilter.
+// The documents fit the eight field names, up to SPOTIFY_MAX_ARTISTS artists and
+// SPOTIFY_TEXT_LEN bytes of title, names and id, far more than the labels show.
+// A larger response stops with NoMemory, what was kept up to there is still applied
+#define SPOTIFY_MAX_ARTISTS 32
+#define SPOTIFY_TEXT_LEN 1024
+#define SPOTIFY_FIELD_NAMES_LEN 64
+#define SPOTIFY_JSON_LEN (JSON_OBJECT_SIZE(8) + JSON_ARRAY_SIZE(SPOTIFY_MAX_ARTISTS) + \
+                          SPOTIFY_FIELD_NAMES_LEN + SPOTIFY_TEXT_LEN)
+
+static StaticJsonDocument<SPOTIFY_JSON_LEN> jsonBuffer;
+static StaticJsonDocument<JSON_OBJECT_SIZE(8)> responseFilter;
 
 // Last fetched track data
 bool lastFetchSuccess = false;
@@ -21,6 +48,47 @@ String currentTrackId = "";
 
 String host = "";
 
+// Button presses queued for the Spotify task, NONE asks for a poll
+enum SpotifyAction {
+  SPOTIFY_ACTION_NONE,
+  SPOTIFY_ACTION_PLAY_PAUSE,
+  SPOTIFY_ACTION_NEXT,
+  SPOTIFY_ACTION_PREV,
+};
+
+// Requests sent to the server, in the order of requestLine()
+enum SpotifyRequest {
+  SPOTIFY_REQUEST_STATUS,
+  SPOTIFY_REQUEST_NOW_PLAYING,
+  SPOTIFY_REQUEST_PLAY,
+  SPOTIFY_REQUEST_PAUSE,
+  SPOTIFY_REQUEST_NEXT,
+  SPOTIFY_REQUEST_PREV,
+};
+
+// Owned by the Spotify task, which keeps one connection to the server open
+static QueueHandle_t actionQueue = NULL;
+static HttpKeepAlive spotifyConn;
+
+// Now-playing state, shared by poll responses on the Spotify task and pushed events
+struct NowPlaying {
+  bool playing;
+  char title[128];
+  char artists[128];
+};
+static NowPlaying nowPlaying;
+static SemaphoreHandle_t stateLock = NULL;
+
+// Owned by the push task, which keeps the event stream open
+static HttpKeepAlive pushConn;
+static SseParser pushParser;
+static StaticJsonDocument<SPOTIFY_JSON_LEN> pushBuffer;
+static volatile bool pushActive = false;
+
+static void showPlayState(bool playing) {
+  postLvglLabelText(play_label, playing ? LV_SYMBOL_PAUSE : LV_SYMBOL_PLAY);
+}
+
 // SSDP settings
 const char* deviceType = "urn:schemas-upnp-org:device:SpotifyServer:1";  // Device type to search for
 const int SSDP_PORT = 1900;
@@ -116,286 +184,492 @@ bool findSpotifyServerWithSSDP() {
 }
 
 
-void initSpotify() {
-  Serial.println("Initializing Spotify API integration...");
-
-  // First try SSDP discovery
-  if (!findSpotifyServerWithSSDP()) {
-    Serial.println("Failed to find Spotify server via SSDP.");
-    // If SSDP fails, try mDNS discovery
-   
-  } 
-
-  // Check if Spotify server is available
-  if (checkSpotifyStatus()) {
+// Called with stateLock held, from a status response or a pushed status event
+static void applyStatus(bool loggedIn) {
+  if (loggedIn && !isConnected) {
     Serial.println("Spotify API connected!");
-    isConnected = true;
-    // Get initial playback state
-    updateNowPlaying();
-  } else {
-    Serial.println("Failed to connect to Spotify API.");
-    isConnected = false;
+  }
+  isConnected = loggedIn;
+  if (!isConnected) {
+    currentTrackId = "";
+    updateCoverArt("");
+    updatePlaybackClock(0, 0, false);
     // Update UI to indicate disconnected state
-    lv_label_set_text(song_title_label, "Spotify not connected");
-    lv_label_set_text(artist_label, "Check server status");
+    postLvglLabelText(song_title_label, "Spotify not connected");
+    postLvglLabelText(artist_label, "Check server status");
+    // Ensure play/pause button shows play when disconnected
+    showPlayState(false);
+    isPlaying = false; // Assume not playing if disconnected
   }
 }
 
-String makeSpotifyRequest(const char* endpoint, const char* method) {
-  HTTPClient http;
-  String url = String(host) + String(endpoint);
-
-
-  Serial.print("Making request to: ");
-  Serial.println(url);
+/*
+ * Called with stateLock held. A snapshot replaces the whole state, a diff only
+ * carries the fields that changed. The labels are posted only when they change.
+ */
+static void applyNowPlaying(JsonObjectConst doc, bool snapshot) {
+  NowPlaying next = nowPlaying;
+  if (snapshot) {
+    next.playing = false;
+    strlcpy(next.title, "Unknown Title", sizeof(next.title));
+    strlcpy(next.artists, "Unknown Artist", sizeof(next.artists));
+  }
+  if (doc.containsKey("isPlaying")) {
+    next.playing = doc["isPlaying"];
+  }
+  if (doc.containsKey("title")) {
+    strlcpy(next.title, doc["title"] | "Unknown Title", sizeof(next.title));
+  }
+  if (doc.containsKey("artists")) {
+    JsonArrayConst artistsArray = doc["artists"];
+    if (!artistsArray.isNull()) {
+      next.artists[0] = '\0';
+      for (size_t i = 0; i < artistsArray.size(); i++) {
+        if (i > 0) strlcat(next.artists, ", ", sizeof(next.artists));
+        strlcat(next.artists, artistsArray[i] | "", sizeof(next.artists));
+      }
+    } else {
+      strlcpy(next.artists, "Unknown Artist", sizeof(next.artists));
+    }
+  }
+  if (doc.containsKey("id")) {
+    const char *id = doc["id"] | "";
+    if (currentTrackId != id) {
+      currentTrackId = id;
+      updateCoverArt(id);
+    }
+  }
 
-  http.begin(url);
+  // Progress comes with snapshots and, when pushed, with seeks and track changes.
+  // The playback clock moves the bar in between, so it needs no extra requests
+  if (snapshot || doc.containsKey("progress") || doc.containsKey("duration") || next.playing != nowPlaying.playing) {
+    updatePlaybackClock(doc["progress"] | (snapshot ? 0L : -1L), doc["duration"] | (snapshot ? 0L : -1L), next.playing);
+  }
 
-  int httpCode = 0;
-  if (strcmp(method, "GET") == 0) {
-    httpCode = http.GET();
-  } else if (strcmp(method, "PUT") == 0) {
-    httpCode = http.PUT("");
-  } else if (strcmp(method, "POST") == 0) {
-    httpCode = http.POST("");
+  // The labels may show an error or a "Loading..." placeholder, a snapshot puts them right
+  bool changed = snapshot || next.playing != nowPlaying.playing ||
+                 strcmp(next.title, nowPlaying.title) != 0 || strcmp(next.artists, nowPlaying.artists) != 0;
+  nowPlaying = next;
+  isPlaying = next.playing;
+  if (!changed) {
+    return;
   }
 
-  String payload = "";
-  if (httpCode > 0) {
-    payload = http.getString();
+  // Update play/pause button icon
+  showPlayState(isPlaying);
+  if (isPlaying) {
+    postLvglLabelText(song_title_label, nowPlaying.title);
+    postLvglLabelText(artist_label, nowPlaying.artists);
   } else {
-    Serial.print("HTTP request failed, error: ");
-    Serial.print(http.errorToString(httpCode));
-    Serial.print(", code: ");
-    Serial.println(httpCode);
-
+    // Nothing playing
+    postLvglLabelText(song_title_label, "Not playing");
+    postLvglLabelText(artist_label, "");
   }
-
-  http.end();
-  return payload;
 }
 
-bool checkSpotifyStatus() {
-  String response = makeSpotifyRequest("/spotify/status", "GET");
+// Parse the body straight from the connection, fields outside the filter are skipped unstored
+static DeserializationError readResponse() {
+  HttpKeepAliveReader reader = {&spotifyConn};
+  return deserializeJson(jsonBuffer, reader, DeserializationOption::Filter(responseFilter));
+}
 
-  if (response.length() > 0) {
-    DeserializationError error = deserializeJson(jsonBuffer, response);
+// Runs on the Spotify task: apply a status response
+static void handleStatus(int status) {
+  bool loggedIn = false;
+  if (status == 200) {
+    DeserializationError error = readResponse();
     if (!error) {
-      return jsonBuffer["isLoggedIn"];
+      loggedIn = jsonBuffer["isLoggedIn"];
     } else {
-        Serial.print("JSON parsing error in checkSpotifyStatus: ");
-        Serial.println(error.c_str());
+      Serial.print("JSON parsing error in status response: ");
+      Serial.println(error.c_str());
     }
   }
-
-  return false;
+  applyStatus(loggedIn);
 }
 
-void updateNowPlaying() {
-  unsigned long currentTime = millis();
-
-  // Only fetch new data every fetchInterval ms
-  if (currentTime - lastFetchTime < fetchInterval) {
+// Runs on the Spotify task: apply a now-playing response
+static void handleNowPlaying(int status) {
+  if (!isConnected) {
+    // The status response in front of it already updated the UI
     return;
   }
+  lastFetchTime = millis();
+  lastFetchSuccess = false;
 
-  lastFetchTime = currentTime;
+  if (status == 200) {
+    DeserializationError error = readResponse();
 
-  if (!isConnected) {
-    // Try to reconnect
-    isConnected = checkSpotifyStatus();
-    if (!isConnected) {
-        // Update UI if still not connected
-        lv_label_set_text(song_title_label, "Spotify not connected");
-        lv_label_set_text(artist_label, "Check server status");
-        // Ensure play/pause button shows play when disconnected
-        lv_obj_t *play_label = lv_obj_get_child(play_btn, 0);
-        if (play_label) {
-            lv_label_set_text(play_label, LV_SYMBOL_PLAY);
-        }
-        isPlaying = false; // Assume not playing if disconnected
-        return;
+    if (!error) {
+      lastFetchSuccess = true;
+      applyNowPlaying(jsonBuffer.as<JsonObjectConst>(), true);
+    } else if (error == DeserializationError::NoMemory) {
+      // Cut short, the fields after the cut keep their last value
+      Serial.println("Now-playing response truncated");
+      lastFetchSuccess = true;
+      applyNowPlaying(jsonBuffer.as<JsonObjectConst>(), false);
+    } else {
+      Serial.print("JSON parsing error in now-playing response: ");
+      Serial.println(error.c_str());
     }
-    // If reconnected, proceed to fetch data
-    Serial.println("Spotify reconnected!");
+  } else {
+    Serial.printf("Failed to get now-playing data (status %d)\n", status);
   }
 
-  String response = makeSpotifyRequest("/spotify/now-playing", "GET");
-
-  if (response.length() > 0) {
-    DeserializationError error = deserializeJson(jsonBuffer, response);
-
-    if (!error) {
-      lastFetchSuccess = true;
+  if (!lastFetchSuccess) {
+    // Update UI to indicate error state if fetch failed
+    postLvglLabelText(song_title_label, "Spotify API error");
+    postLvglLabelText(artist_label, "Check connection");
+    // Ensure play/pause button shows play on error
+    showPlayState(false);
+    isPlaying = false; // Assume not playing on error
+    nowPlaying.playing = false;
+    updatePlaybackClock(-1, -1, false);
+  }
+}
 
-      // Check if a track is playing
-      isPlaying = jsonBuffer["isPlaying"];
+// Runs on the Spotify task: apply the response to a button press
+static void handleControl(SpotifyRequest request, int status) {
+  bool success = false;
+  if (status == 200) {
+    DeserializationError error = readResponse();
+    success = !error && jsonBuffer["success"];
+  }
 
-      // Update play/pause button icon
-      lv_obj_t *play_label = lv_obj_get_child(play_btn, 0);
-      if (play_label) { // Check if play_label exists
-          if (isPlaying) {
-            lv_label_set_text(play_label, LV_SYMBOL_PAUSE);
-          } else {
-            lv_label_set_text(play_label, LV_SYMBOL_PLAY);
-          }
+  switch (request) {
+    case SPOTIFY_REQUEST_PLAY:
+    case SPOTIFY_REQUEST_PAUSE:
+      if (success) {
+        Serial.printf("Playback %s successful\n", request == SPOTIFY_REQUEST_PLAY ? "play" : "pause");
+        // Toggle state immediately for responsiveness
+        isPlaying = request == SPOTIFY_REQUEST_PLAY;
+        nowPlaying.playing = isPlaying;
+        showPlayState(isPlaying);
+        updatePlaybackClock(-1, -1, isPlaying);
+      } else {
+        Serial.printf("Failed to %s playback (status %d)\n", request == SPOTIFY_REQUEST_PLAY ? "start" : "pause", status);
+      }
+      break;
+    case SPOTIFY_REQUEST_NEXT:
+    case SPOTIFY_REQUEST_PREV:
+      if (success) {
+        Serial.printf("Skipped to %s track successfully\n", request == SPOTIFY_REQUEST_NEXT ? "next" : "previous");
+        // Optimistically update UI before the new track info arrives
+        postLvglLabelText(song_title_label, request == SPOTIFY_REQUEST_NEXT ? "Loading next..." : "Loading previous...");
+        postLvglLabelText(artist_label, "");
       } else {
-          Serial.println("Error: play_btn label not found!");
+        Serial.printf("Failed to skip track (status %d)\n", status);
       }
+      break;
+    default:
+      break;
+  }
+}
 
-      if (isPlaying) {
-        // Extract track info
-        const char* title = jsonBuffer["title"] | "Unknown Title"; // Provide default
-        String artists = "";
+static void handleResponse(SpotifyRequest request, int status) {
+  xSemaphoreTake(stateLock, portMAX_DELAY);
+  switch (request) {
+    case SPOTIFY_REQUEST_STATUS:
+      handleStatus(status);
+      break;
+    case SPOTIFY_REQUEST_NOW_PLAYING:
+      handleNowPlaying(status);
+      break;
+    default:
+      handleControl(request, status);
+      break;
+  }
+  xSemaphoreGive(stateLock);
+}
 
-        JsonArray artistsArray = jsonBuffer["artists"];
-        if (!artistsArray.isNull()) {
-            for (int i = 0; i < artistsArray.size(); i++) {
-              if (i > 0) artists += ", ";
-              artists += artistsArray[i].as<String>();
-            }
-        } else {
-            artists = "Unknown Artist";
-        }
+static void requestLine(SpotifyRequest request, const char **method, const char **path) {
+  static const char *const methods[] = {"GET", "GET", "PUT", "PUT", "POST", "POST"};
+  static const char *const paths[] = {
+    "/spotify/status", "/spotify/now-playing", "/spotify/playback/play",
+    "/spotify/playback/pause", "/spotify/skip/next", "/spotify/skip/previous",
+  };
+  *method = methods[request];
+  *path = paths[request];
+}
 
-        // Track ID
-        currentTrackId = jsonBuffer["id"].as<String>();
+// A skip that reached the server before it dropped the connection would be done twice
+static bool canResend(SpotifyRequest request) {
+  return request != SPOTIFY_REQUEST_NEXT && request != SPOTIFY_REQUEST_PREV;
+}
 
-        // Update UI
-        lv_label_set_text(song_title_label, title);
-        lv_label_set_text(artist_label, artists.c_str());
-      } else {
-        // Nothing playing
-        lv_label_set_text(song_title_label, "Not playing");
-        lv_label_set_text(artist_label, "");
+/*
+ * Send the whole batch on the kept-alive connection, then read the responses in order.
+ * Requests the server dropped without answering, and those that were never written,
+ * are sent once more on a new connection, except skips. A timeout is not retried,
+ * the server may still be working on the request.
+ */
+static void runBatch(const SpotifyRequest *batch, int count, bool retry) {
+  int sent = 0;
+  for (; sent < count; sent++) {
+    const char *method;
+    const char *path;
+    requestLine(batch[sent], &method, &path);
+    if (!httpKeepAliveSend(&spotifyConn, method, path)) {
+      break;
+    }
+  }
+
+  SpotifyRequest again[SPOTIFY_QUEUE_LEN + 2];
+  int resend = 0;
+  int done = 0;
+  for (; done < sent; done++) {
+    int status = httpKeepAliveReceiveHead(&spotifyConn);
+    if (status == HTTP_KEEPALIVE_ERR_CLOSED && retry) {
+      // Closed before the first byte of this response, none of the rest was answered either
+      for (; done < sent; done++) {
+        if (canResend(batch[done])) {
+          again[resend++] = batch[done];
+        } else {
+          handleResponse(batch[done], status);
+        }
       }
-    } else {
-      Serial.print("JSON parsing error in updateNowPlaying: ");
-      Serial.println(error.c_str());
-      lastFetchSuccess = false;
+      break;
     }
-  } else {
-    lastFetchSuccess = false;
-    Serial.println("Failed to get now-playing data (empty response)");
+    handleResponse(batch[done], status);
+    // Skip what the parser left, so the connection is ready for the next response
+    char rest[64];
+    while (httpKeepAliveBodyRead(&spotifyConn, rest, sizeof(rest)) > 0) {
+    }
+    if (status < 0) {
+      done++;
+      break;
+    }
+  }
+  for (; done < sent; done++) {
+    handleResponse(batch[done], HTTP_KEEPALIVE_ERR_IO);
   }
 
-  if (!lastFetchSuccess) {
-    // Update UI to indicate error state if fetch failed
-    lv_label_set_text(song_title_label, "Spotify API error");
-    lv_label_set_text(artist_label, "Check connection");
-    // Ensure play/pause button shows play on error
-    lv_obj_t *play_label = lv_obj_get_child(play_btn, 0);
-    if (play_label) {
-        lv_label_set_text(play_label, LV_SYMBOL_PLAY);
+  // The request that failed to go out was at most partly written, the server ignores it
+  for (; sent < count; sent++) {
+    if (retry) {
+      again[resend++] = batch[sent];
+    } else {
+      handleResponse(batch[sent], HTTP_KEEPALIVE_ERR_IO);
     }
-    isPlaying = false; // Assume not playing on error
+  }
+  if (resend) {
+    runBatch(again, resend, false);
   }
 }
 
-void togglePlayPause() {
+// Turn the queued button presses and the periodic poll into one pipelined batch
+static int buildBatch(const SpotifyAction *actions, int count, bool poll, SpotifyRequest *batch) {
+  int n = 0;
   if (!isConnected) {
-    Serial.println("Spotify not connected, attempting reconnect...");
-    initSpotify(); // Try to reconnect
-    if (!isConnected) {
-        Serial.println("Reconnect failed.");
-        return;
+    batch[n++] = SPOTIFY_REQUEST_STATUS;
+  }
+  bool playing = isPlaying;
+  for (int i = 0; i < count; i++) {
+    switch (actions[i]) {
+      case SPOTIFY_ACTION_PLAY_PAUSE:
+        batch[n++] = playing ? SPOTIFY_REQUEST_PAUSE : SPOTIFY_REQUEST_PLAY;
+        playing = !playing;
+        break;
+      case SPOTIFY_ACTION_NEXT:
+      case SPOTIFY_ACTION_PREV:
+        if (!playing) {
+          Serial.println("Not playing, cannot skip");
+          break;
+        }
+        batch[n++] = actions[i] == SPOTIFY_ACTION_NEXT ? SPOTIFY_REQUEST_NEXT : SPOTIFY_REQUEST_PREV;
+        break;
+      default:
+        break;
     }
   }
+  if (poll) {
+    batch[n++] = SPOTIFY_REQUEST_NOW_PLAYING;
+  }
+  return n;
+}
 
-  Serial.println("Toggle play/pause via API");
-
-  const char* endpoint = isPlaying ? "/spotify/playback/pause" : "/spotify/playback/play";
-  String response = makeSpotifyRequest(endpoint, "PUT");
-
-  // Clear previous JSON data before parsing new response
-  jsonBuffer.clear();
-  DeserializationError error = deserializeJson(jsonBuffer, response);
+static void spotifyTask(void *args) {
+  unsigned long nextPoll = millis();
+  bool refresh = false;
+  for (;;) {
+    // Sleep until a button is pressed or the next poll is due
+    long wait = (long)(nextPoll - millis());
+    SpotifyAction actions[SPOTIFY_QUEUE_LEN];
+    int count = 0;
+    if (xQueueReceive(actionQueue, &actions[0], wait > 0 ? pdMS_TO_TICKS(wait) : 0) == pdTRUE) {
+      count = 1;
+      while (count < SPOTIFY_QUEUE_LEN && xQueueReceive(actionQueue, &actions[count], 0) == pdTRUE) {
+        count++;
+      }
+    }
+    bool due = (long)(millis() - nextPoll) >= 0;
+    if (due) {
+      nextPoll = millis() + fetchInterval;
+    }
+    // While events are pushed, only poll when asked to, after a button press or to log in again
+    bool poll = due && (!pushActive || !isConnected || refresh);
+    for (int i = 0; i < count; i++) {
+      poll |= actions[i] == SPOTIFY_ACTION_NONE;
+    }
+    if (!poll && count == 0) {
+      continue;
+    }
+    refresh = !poll;
+    if (refresh && (long)(nextPoll - millis()) > SPOTIFY_REFRESH_DELAY) {
+      // Spotify needs a moment before it reports the result of a button press
+      nextPoll = millis() + SPOTIFY_REFRESH_DELAY;
+    }
 
-  bool success = false;
-  if (!error && jsonBuffer.containsKey("success")) {
-      success = jsonBuffer["success"];
-  }
-
-  if (success) {
-      Serial.printf("Playback %s successful\n", isPlaying ? "pause" : "play");
-      // Toggle state immediately for responsiveness
-      isPlaying = !isPlaying;
-      // Update button icon immediately
-      lv_obj_t *play_label = lv_obj_get_child(play_btn, 0);
-      if (play_label) {
-          lv_label_set_text(play_label, isPlaying ? LV_SYMBOL_PAUSE : LV_SYMBOL_PLAY);
+    if (WiFi.status() != WL_CONNECTED) {
+      continue;
+    }
+    if (spotifyConn.host[0] == '\0') {
+      // Server not found yet, look for it again at poll time
+      if (!poll || !findSpotifyServerWithSSDP() ||
+          !httpKeepAliveBegin(&spotifyConn, host.c_str(), SPOTIFY_TIMEOUT_MS)) {
+        spotifyConn.host[0] = '\0';
+        continue;
       }
-  } else {
-      Serial.printf("Failed to %s playback. Error: %s\n", isPlaying ? "pause" : "play", error.c_str());
-      // Don't change isPlaying state if API call failed
-  }
+    }
 
-  // Fetch updated state after a short delay to confirm
-  delay(200); // Increased delay slightly
-  updateNowPlaying();
+    SpotifyRequest batch[SPOTIFY_QUEUE_LEN + 2];
+    int n = buildBatch(actions, count, poll, batch);
+    runBatch(batch, n, true);
+  }
 }
 
-void nextTrack() {
-  if (!isConnected) {
-    Serial.println("Spotify not connected");
+// Runs on the push task for every complete event of the stream
+static void onPushEvent(const char *event, const char *data, size_t len, void *arg) {
+  DeserializationError error = deserializeJson(pushBuffer, data, len, DeserializationOption::Filter(responseFilter));
+  bool truncated = error == DeserializationError::NoMemory;
+  if (truncated) {
+    Serial.printf("Pushed %s event truncated\n", event);
+  } else if (error) {
+    Serial.printf("JSON parsing error in pushed %s event: %s\n", event, error.c_str());
     return;
   }
-   if (!isPlaying) {
-    Serial.println("Not playing, cannot skip next");
-    return;
+
+  xSemaphoreTake(stateLock, portMAX_DELAY);
+  if (strcmp(event, "status") == 0) {
+    applyStatus(pushBuffer["isLoggedIn"]);
+  } else if (isConnected && (strcmp(event, "state") == 0 || strcmp(event, "diff") == 0)) {
+    lastFetchTime = millis();
+    lastFetchSuccess = true;
+    applyNowPlaying(pushBuffer.as<JsonObjectConst>(), event[0] == 's' && !truncated);
   }
+  xSemaphoreGive(stateLock);
+}
 
-  Serial.println("Skip to next track via API");
+/*
+ * Keep the event stream of the server open. It starts with a "state" event
+ * holding the full now-playing state, followed by "diff" events with only the
+ * fields that changed. While it is up the Spotify task stops polling, when it
+ * drops polling takes over and the stream is opened again with backoff.
+ */
+static void spotifyPushTask(void *args) {
+  uint32_t backoff = SPOTIFY_PUSH_BACKOFF_MIN;
+  for (;;) {
+    if (WiFi.status() != WL_CONNECTED || spotifyConn.host[0] == '\0') {
+      vTaskDelay(pdMS_TO_TICKS(SPOTIFY_PUSH_BACKOFF_MIN));
+      continue;
+    }
 
-  String response = makeSpotifyRequest("/spotify/skip/next", "POST");
-  // Clear previous JSON data before parsing new response
-  jsonBuffer.clear();
-  DeserializationError error = deserializeJson(jsonBuffer, response);
-  if (!error && jsonBuffer.containsKey("success") && jsonBuffer["success"]) {
-    Serial.println("Skipped to next track successfully");
-    // Optimistically update UI slightly faster
-    lv_label_set_text(song_title_label, "Loading next...");
-    lv_label_set_text(artist_label, "");
-  } else {
-    Serial.printf("Failed to skip to next track. Error: %s\n", error.c_str());
-  }
+    char url[HTTP_KEEPALIVE_HOST_LEN + 16];
+    snprintf(url, sizeof(url), "http://%s:%u", spotifyConn.host, spotifyConn.port);
+    httpKeepAliveBegin(&pushConn, url, SPOTIFY_TIMEOUT_MS);
+    int status = httpKeepAliveStreamOpen(&pushConn, SPOTIFY_PUSH_PATH, "text/event-stream", SPOTIFY_PUSH_IDLE_MS);
+    if (status == 200) {
+      Serial.println("Spotify push connected");
+      backoff = SPOTIFY_PUSH_BACKOFF_MIN;
+      pushActive = true;
+      sseParserBegin(&pushParser, onPushEvent, NULL);
+      char buf[256];
+      int n;
+      while ((n = httpKeepAliveBodyRead(&pushConn, buf, sizeof(buf))) > 0) {
+        uint32_t dropped = pushParser.dropped;
+        sseParserFeed(&pushParser, buf, n);
+        if (pushParser.dropped != dropped) {
+          // The server should leave coverSmall out of events, poll for what was lost
+          Serial.printf("Pushed event dropped, larger than %d bytes\n", SSE_DATA_LEN);
+          updateNowPlaying();
+        }
+      }
+      pushActive = false;
+      Serial.println("Spotify push lost, polling until it is back");
+      // Catch up on what changed while the stream was down
+      updateNowPlaying();
+    } else if (status == 404 || status == HTTP_KEEPALIVE_ERR_PROTOCOL) {
+      Serial.printf("Spotify server does not push updates (status %d), polling\n", status);
+      vTaskDelay(pdMS_TO_TICKS(SPOTIFY_PUSH_RETRY_UNSUPPORTED));
+      continue;
+    }
 
-  // Update the UI after a delay to get new track info
-  delay(500); // Increased delay to allow Spotify state to update
-  updateNowPlaying();
+    vTaskDelay(pdMS_TO_TICKS(backoff));
+    backoff = min(backoff * 2, (uint32_t)SPOTIFY_PUSH_BACKOFF_MAX);
+  }
 }
 
-void previousTrack() {
-   if (!isConnected) {
-    Serial.println("Spotify not connected");
-    return;
+void initSpotify() {
+  Serial.println("Initializing Spotify API integration...");
+
+  // First try SSDP discovery
+  if (!findSpotifyServerWithSSDP()) {
+    Serial.println("Failed to find Spotify server via SSDP.");
+    // If SSDP fails, try mDNS discovery
+   
+  } 
+
+  const char *const fields[] = {"isLoggedIn", "success", "isPlaying", "title", "artists", "id", "progress", "duration"};
+  for (const char *field : fields) {
+    responseFilter[field] = true;
   }
-   if (!isPlaying) {
-    Serial.println("Not playing, cannot skip previous");
+
+  actionQueue = xQueueCreate(SPOTIFY_QUEUE_LEN, sizeof(SpotifyAction));
+  stateLock = xSemaphoreCreateMutex();
+  if (!actionQueue || !stateLock) {
+    Serial.println("Failed to allocate the Spotify client.");
     return;
   }
+  if (host.length() == 0 || !httpKeepAliveBegin(&spotifyConn, host.c_str(), SPOTIFY_TIMEOUT_MS)) {
+    spotifyConn.host[0] = '\0';
+  }
 
-  Serial.println("Go to previous track via API");
+  initCoverArt();
 
-  String response = makeSpotifyRequest("/spotify/skip/previous", "POST");
-  // Clear previous JSON data before parsing new response
-  jsonBuffer.clear();
-  DeserializationError error = deserializeJson(jsonBuffer, response);
-  if (!error && jsonBuffer.containsKey("success") && jsonBuffer["success"]) {
-    Serial.println("Skipped to previous track successfully");
-    // Optimistically update UI slightly faster
-    lv_label_set_text(song_title_label, "Loading previous...");
-    lv_label_set_text(artist_label, "");
-  } else {
-    Serial.printf("Failed to skip to previous track. Error: %s\n", error.c_str());
+  // Requests run on their own task, the first poll goes out right away
+  if (xTaskCreatePinnedToCore(spotifyTask, "spotify", SPOTIFY_TASK_STACK, NULL, 1, NULL, 0) != pdPASS) {
+    Serial.println("Failed to start the Spotify task.");
+  }
+  // Pushed updates replace most polls when the server supports them
+  if (xTaskCreatePinnedToCore(spotifyPushTask, "spotify-push", SPOTIFY_TASK_STACK, NULL, 1, NULL, 0) != pdPASS) {
+    Serial.println("Failed to start the Spotify push task, polling only.");
+  }
+}
+
+static void queueAction(SpotifyAction action) {
+  if (!actionQueue || xQueueSend(actionQueue, &action, 0) != pdTRUE) {
+    Serial.println("Spotify busy, button press dropped");
   }
+}
 
-  // Update the UI after a delay to get new track info
-  delay(500); // Increased delay to allow Spotify state to update
-  updateNowPlaying();
+void updateNowPlaying() {
+  // An empty batch is topped up with the poll
+  queueAction(SPOTIFY_ACTION_NONE);
 }
 
-// Button callbacks
+void togglePlayPause() {
+  queueAction(SPOTIFY_ACTION_PLAY_PAUSE);
+}
+
+void nextTrack() {
+  queueAction(SPOTIFY_ACTION_NEXT);
+}
+
+void previousTrack() {
+  queueAction(SPOTIFY_ACTION_PREV);
+}
+
+// Button callbacks run on the render task, they only queue the press for the Spotify task
 void spotify_play_callback(lv_event_t *e) {
   togglePlayPause();
 }
@@ -406,4 +680,4 @@ void spotify_next_callback(lv_event_t *e) {
 
 void spotify_prev_callback(lv_event_t *e) {
   previousTrack();
-}
\ No newline at end of file
+}
@@ -19,41 +19,33 @@
 #define SPOTIFY_SERVER_HOST_prefix "http://192.168.0."
 
 /**
- * @brief Initialize Spotify API connection
+ * @brief Find the Spotify server and start the tasks that talk to it
+ * @note Now-playing changes are pushed over /spotify/events when the server
+ *       supports it, otherwise they are polled
  */
 void initSpotify();
 
 /**
- * @brief Update currently playing song info from API
+ * @brief Ask the Spotify task for the currently playing song right away
+ * @note It also polls every fetchInterval ms on its own while no updates are pushed
  */
 void updateNowPlaying();
 
 /**
- * @brief Update album cover display using the API data
- */
-void updateCoverArt();
-
-/**
- * @brief Toggle play/pause via API
+ * @brief Toggle play/pause via API, queued for the Spotify task
  */
 void togglePlayPause();
 
 /**
- * @brief Skip to next track via API
+ * @brief Skip to next track via API, queued for the Spotify task
  */
 void nextTrack();
 
 /**
- * @brief Go back to previous track via API
+ * @brief Go back to previous track via API, queued for the Spotify task
  */
 void previousTrack();
 
-/**
- * @brief Check Spotify authentication status
- * @return true if authenticated, false otherwise
- */
-bool checkSpotifyStatus();
-
 /**
  * @brief Callback for play/pause button
  */
@@ -69,38 +61,6 @@ void spotify_next_callback(lv_event_t *e);
  */
 void spotify_prev_callback(lv_event_t *e);
 
-/**
- * @brief HTTP request to Spotify API server
- * @param endpoint API endpoint
- * @param method HTTP method (GET, PUT, POST)
- * @return JSON response as String
- */
-String makeSpotifyRequest(const char* endpoint, const char* method);
-
-/**
- * @brief Parse base64 image data from API response
- * @param base64Data Base64 encoded image
- * @return true if successful, false otherwise
- */
-bool parseBase64Image(const char* base64Data);
-
-/**
- * @brief Download image from URL
- * @param url URL of the image
- * @return true if successful, false otherwise
- */
-bool downloadImageFromUrl(const char* url);
-
-/**
- * @brief Process image data
- * @param data_len Length of the image data
- * @return true if successful, false otherwise
- */
-bool processImageData(size_t data_len);
-
-// Global reference to cover art placeholder
-extern lv_obj_t *cover_img;
-
 // Last fetched track data
 extern bool lastFetchSuccess;
 extern unsigned long lastFetchTime;
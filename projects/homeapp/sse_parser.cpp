@@ -0,0 +1,95 @@
+/**
+ * @file      sse_parser.cpp
+ * @brief     Incremental parser for Server-Sent Events (text/event-stream)
+ */
+
+#include "sse_parser.h"
+#include <string.h>
+
+static void resetEvent(SseParser *parser) {
+  parser->event[0] = '\0';
+  parser->data[0] = '\0';
+  parser->dataLen = 0;
+  parser->overflow = false;
+}
+
+static void dispatch(SseParser *parser) {
+  if (parser->overflow) {
+    parser->dropped++;
+  } else if (parser->dataLen > 0) {
+    // The last data line does not keep its newline
+    parser->data[--parser->dataLen] = '\0';
+    parser->callback(parser->event[0] ? parser->event : "message", parser->data, parser->dataLen, parser->arg);
+  }
+  resetEvent(parser);
+}
+
+static void processLine(SseParser *parser) {
+  char *line = parser->line;
+  if (parser->lineLen == 0) {
+    dispatch(parser);
+    return;
+  }
+  if (line[0] == ':') {
+    // Comment, servers send them to keep the stream alive
+    return;
+  }
+
+  char *value = strchr(line, ':');
+  if (value) {
+    *value++ = '\0';
+    if (*value == ' ') {
+      value++;
+    }
+  } else {
+    value = line + parser->lineLen;
+  }
+
+  if (strcmp(line, "event") == 0) {
+    strncpy(parser->event, value, SSE_EVENT_LEN - 1);
+    parser->event[SSE_EVENT_LEN - 1] = '\0';
+  } else if (strcmp(line, "data") == 0) {
+    size_t len = strlen(value);
+    if (parser->dataLen + len + 1 >= SSE_DATA_LEN) {
+      parser->overflow = true;
+      return;
+    }
+    memcpy(parser->data + parser->dataLen, value, len);
+    parser->dataLen += len;
+    parser->data[parser->dataLen++] = '\n';
+    parser->data[parser->dataLen] = '\0';
+  }
+  // id and retry are not used
+}
+
+void sseParserBegin(SseParser *parser, SseEventCallback callback, void *arg) {
+  parser->lineLen = 0;
+  parser->skipLf = false;
+  parser->dropped = 0;
+  parser->callback = callback;
+  parser->arg = arg;
+  resetEvent(parser);
+}
+
+void sseParserFeed(SseParser *parser, const char *buf, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    char c = buf[i];
+    if (parser->skipLf) {
+      parser->skipLf = false;
+      if (c == '\n') {
+        continue;
+      }
+    }
+    if (c == '\r' || c == '\n') {
+      parser->skipLf = c == '\r';
+      parser->line[parser->lineLen] = '\0';
+      processLine(parser);
+      parser->lineLen = 0;
+    } else if (parser->lineLen < SSE_DATA_LEN - 1) {
+      parser->line[parser->lineLen++] = c;
+    } else {
+      // A line longer than the data buffer cannot be kept
+      parser->overflow = true;
+    }
+  }
+}
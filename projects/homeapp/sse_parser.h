@@ -0,0 +1,50 @@
+/**
+ * @file      sse_parser.h
+ * @brief     Incremental parser for Server-Sent Events (text/event-stream)
+ *
+ * Fed with whatever the connection delivers, it calls back once per complete
+ * event. Plain C++ without Arduino dependencies, like http_keepalive.
+ */
+
+#ifndef SSE_PARSER_H
+#define SSE_PARSER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SSE_EVENT_LEN 32
+// Largest event kept, data lines included. Events do not carry the cover,
+// see projects/docs/spotify-api.md, larger ones are dropped and counted
+#define SSE_DATA_LEN 2048
+
+/**
+ * @brief Called for every event
+ * @param event Event name, "message" when the server did not name it
+ * @param data Data lines joined with '\n', NUL terminated
+ */
+typedef void (*SseEventCallback)(const char *event, const char *data, size_t len, void *arg);
+
+struct SseParser {
+  char line[SSE_DATA_LEN];
+  size_t lineLen;
+  bool skipLf;                      // Last line ended with CR, a following LF belongs to it
+  bool overflow;                    // Event data did not fit, the event is dropped
+  char event[SSE_EVENT_LEN];
+  char data[SSE_DATA_LEN];
+  size_t dataLen;
+  uint32_t dropped;                 // Events dropped for not fitting, since sseParserBegin()
+  SseEventCallback callback;
+  void *arg;
+};
+
+/**
+ * @brief Reset the parser, call for every new stream
+ */
+void sseParserBegin(SseParser *parser, SseEventCallback callback, void *arg);
+
+/**
+ * @brief Parse the next bytes of the stream, they may end anywhere
+ */
+void sseParserFeed(SseParser *parser, const char *buf, size_t len);
+
+#endif // SSE_PARSER_H
@@ -10,6 +10,16 @@
 #define ACCENT_RED          0xE53935 // Red for errors
 #define ACCENT_ORANGE       0xFF9800 // Orange for warnings
 
+// What the status label currently shows, the label itself belongs to the render task
+static bool shownConnected = false;
+
+static void showConnected() {
+  postLvglLabelText(status_label, "WiFi: CONNECTED");
+  postLvglTextColor(status_label, ACCENT_GREEN);
+  postLvglLabelTextFmt(ip_label, "IP: %s", WiFi.localIP().toString().c_str());
+  shownConnected = true;
+}
+
 void initWiFi() {
   Serial.println("Initializing WiFi...");
   WiFi.mode(WIFI_STA);
@@ -19,10 +29,8 @@ void connectToWiFi() {
   Serial.printf("Connecting to WiFi: %s\n", ssid);
   
   // Update display to indicate connection attempt
-  if (status_label != NULL) {
-    lv_label_set_text(status_label, "WiFi: CONNECTING...");
-    // No background color changes in dark theme, just text
-  }
+  // No background color changes in dark theme, just text
+  postLvglLabelText(status_label, "WiFi: CONNECTING...");
   
   // Start connection
   WiFi.begin(ssid, password);
@@ -32,7 +40,6 @@ void connectToWiFi() {
   while (WiFi.status() != WL_CONNECTED && millis() - startAttempt < 10000) {
     delay(500);
     Serial.print(".");
-    lv_task_handler(); // Keep the UI responsive during connection
   }
   
   // Check if connected
@@ -41,26 +48,15 @@ void connectToWiFi() {
     Serial.print("IP address: ");
     Serial.println(WiFi.localIP());
     
-    // Update display with connected info
-    if (status_label != NULL) {
-      lv_label_set_text(status_label, "WiFi: CONNECTED");
-      lv_obj_set_style_text_color(status_label, lv_color_hex(ACCENT_GREEN), 0);
-    }
-    
-    // Update IP display
-    if (ip_label != NULL) {
-      char ipStr[20];
-      snprintf(ipStr, sizeof(ipStr), "IP: %s", WiFi.localIP().toString().c_str());
-      lv_label_set_text(ip_label, ipStr);
-    }
+    // Update display with connected info and IP
+    showConnected();
   } else {
     Serial.println("\nWiFi connection failed!");
     
     // Update display with connection failure
-    if (status_label != NULL) {
-      lv_label_set_text(status_label, "WiFi: CONNECTION FAILED");
-      lv_obj_set_style_text_color(status_label, lv_color_hex(ACCENT_RED), 0);
-    }
+    postLvglLabelText(status_label, "WiFi: CONNECTION FAILED");
+    postLvglTextColor(status_label, ACCENT_RED);
+    shownConnected = false;
   }
 }
 
@@ -73,10 +69,11 @@ void checkWiFiStatus() {
     
     if (WiFi.status() != WL_CONNECTED) {
       // If we've lost connection, update the display
-      if (status_label != NULL && strcmp(lv_label_get_text(status_label), "WiFi: CONNECTED") == 0) {
+      if (shownConnected) {
         Serial.println("WiFi connection lost! Attempting to reconnect...");
-        lv_label_set_text(status_label, "WiFi: RECONNECTING...");
-        lv_obj_set_style_text_color(status_label, lv_color_hex(ACCENT_ORANGE), 0);
+        postLvglLabelText(status_label, "WiFi: RECONNECTING...");
+        postLvglTextColor(status_label, ACCENT_ORANGE);
+        shownConnected = false;
       }
       
       // Attempt to reconnect
@@ -90,18 +87,7 @@ void checkWiFiStatus() {
       if (WiFi.status() == WL_CONNECTED) {
         Serial.println("WiFi reconnected!");
         
-        // Only update UI if elements exist
-        if (status_label != NULL) {
-          lv_label_set_text(status_label, "WiFi: CONNECTED");
-          lv_obj_set_style_text_color(status_label, lv_color_hex(ACCENT_GREEN), 0);
-        }
-        
-        if (ip_label != NULL) {
-          // Update IP display
-          char ipStr[20];
-          snprintf(ipStr, sizeof(ipStr), "IP: %s", WiFi.localIP().toString().c_str());
-          lv_label_set_text(ip_label, ipStr);
-        }
+        showConnected();
       }
     }
   }
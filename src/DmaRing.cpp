@@ -0,0 +1,101 @@
+/**
+ * @file      DmaRing.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2025  Shenzhen Xin Yuan Electronic Technology Co., Ltd
+ * @date      2025-03-18
+ *
+ */
+
+#include "DmaRing.h"
+#include <string.h>
+#include <driver/gpio.h>
+#include <esp_attr.h>
+#include <esp32-hal-log.h>
+
+void dma_ring_init(DmaRing_t *ring, spi_device_handle_t spi, int cs)
+{
+    memset(ring->slots, 0, sizeof(ring->slots));
+    ring->spi = spi;
+    ring->cs = cs;
+    ring->head = 0;
+    ring->pending = 0;
+}
+
+spi_transaction_ext_t *dma_ring_acquire(DmaRing_t *ring, uint8_t flags, uint8_t depth)
+{
+    // Reclaim the oldest transaction before reusing its slot
+    while (ring->pending >= depth) {
+        spi_transaction_t *trans_result;
+        esp_err_t ret = spi_device_get_trans_result(ring->spi, &trans_result, portMAX_DELAY);
+        if (ret != ESP_OK) {
+            log_e("DMA SPI transfer failed!");
+        }
+        ring->pending--;
+    }
+
+    DmaSlot_t *slot = &ring->slots[ring->head];
+    ring->head = (ring->head + 1) % AMOLED_DMA_QUEUE_SIZE;
+    memset(&slot->t, 0, sizeof(spi_transaction_ext_t));
+    slot->ring = ring;
+    slot->flags = flags;
+    slot->t.base.user = slot;
+    return &slot->t;
+}
+
+bool dma_ring_queue(DmaRing_t *ring, spi_transaction_ext_t *t)
+{
+    esp_err_t ret = spi_device_queue_trans(ring->spi, &t->base, portMAX_DELAY);
+    if (ret != ESP_OK) {
+        log_e("DMA transfer failed!");
+        // Let the queued part of the stream go out first, its callbacks still drive CS
+        dma_ring_wait(ring);
+        DmaSlot_t *slot = (DmaSlot_t *)t->base.user;
+        if (slot->flags & DMA_SLOT_END) {
+            gpio_set_level((gpio_num_t)ring->cs, 1);
+        }
+        if ((slot->flags & DMA_SLOT_FLUSH) && ring->done) {
+            ring->done(ring->doneArg);
+        }
+        return false;
+    }
+    ring->pending++;
+    return true;
+}
+
+void dma_ring_wait(DmaRing_t *ring)
+{
+    while (ring->pending) {
+        spi_transaction_t *trans_result;
+        esp_err_t ret = spi_device_get_trans_result(ring->spi, &trans_result, portMAX_DELAY);
+        if (ret != ESP_OK) {
+            log_e("DMA SPI transfer failed!");
+            ring->pending = 0;
+            break;
+        }
+        ring->pending--;
+    }
+}
+
+void IRAM_ATTR dma_ring_pre_callback(spi_transaction_t *t)
+{
+    DmaSlot_t *slot = (DmaSlot_t *)t->user;
+    if (slot && (slot->flags & DMA_SLOT_BEGIN)) {
+        gpio_set_level((gpio_num_t)slot->ring->cs, 0);
+    }
+}
+
+void IRAM_ATTR dma_ring_post_callback(spi_transaction_t *t)
+{
+    DmaSlot_t *slot = (DmaSlot_t *)t->user;
+    if (!slot) {
+        return;
+    }
+    DmaRing_t *ring = slot->ring;
+    if (slot->flags & DMA_SLOT_END) {
+        gpio_set_level((gpio_num_t)ring->cs, 1);
+    }
+    if ((slot->flags & DMA_SLOT_FLUSH) && ring->done) {
+        ring->done(ring->doneArg);
+    }
+}
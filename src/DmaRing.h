@@ -0,0 +1,81 @@
+/**
+ * @file      DmaRing.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2025  Shenzhen Xin Yuan Electronic Technology Co., Ltd
+ * @date      2025-03-18
+ * @note      Ring of queued SPI transactions used by the QSPI flush
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <driver/spi_master.h>
+
+#ifndef AMOLED_DMA_QUEUE_SIZE
+#define AMOLED_DMA_QUEUE_SIZE   (8)     //Maximum number of chunk transactions in flight
+#endif
+
+// DMA slot flags
+#define DMA_SLOT_BEGIN          (0x01)  //Assert CS before the transaction
+#define DMA_SLOT_END            (0x02)  //Release CS after the transaction
+#define DMA_SLOT_FLUSH          (0x04)  //Last transaction of a flush, call done
+
+struct __DmaRing;
+
+typedef struct __DmaSlot {
+    spi_transaction_ext_t t;
+    struct __DmaRing *ring;
+    uint8_t flags;
+} DmaSlot_t;
+
+/*
+* Transactions are taken from the ring in order and queued to the SPI driver,
+* which hands them back in the same order. A slot is only reused after the
+* driver returned it, so at most AMOLED_DMA_QUEUE_SIZE are ever in flight.
+* CS is driven from the driver callbacks, the device must be added with
+* spics_io_num = -1 and dma_ring_pre_callback / dma_ring_post_callback.
+* */
+typedef struct __DmaRing {
+    spi_device_handle_t spi;
+    int cs;
+    DmaSlot_t slots[AMOLED_DMA_QUEUE_SIZE];
+    uint8_t head;
+    uint8_t pending;                // Queued and not yet returned by the driver
+    void (*done)(void *arg);        // Called when the last slot of a flush completes, may run in an ISR
+    void *doneArg;
+} DmaRing_t;
+
+/**
+ * @brief  Reset the ring for a device
+ * @param  ring: Ring to reset
+ * @param  spi: Device the transactions are queued to
+ * @param  cs: Chip select pin driven by the callbacks
+ */
+void dma_ring_init(DmaRing_t *ring, spi_device_handle_t spi, int cs);
+
+/**
+ * @brief  Take the next slot, waiting for the driver to return old transactions first
+ * @param  ring: Ring to take from
+ * @param  flags: DMA_SLOT_* flags of the transaction
+ * @param  depth: Transactions allowed in flight once this one is queued, 1 to AMOLED_DMA_QUEUE_SIZE
+ * @retval Cleared transaction, to be passed to dma_ring_queue
+ */
+spi_transaction_ext_t *dma_ring_acquire(DmaRing_t *ring, uint8_t flags, uint8_t depth);
+
+/**
+ * @brief  Queue a transaction taken with dma_ring_acquire
+ * @note   When the driver refuses it, the queued transactions are waited for,
+ *         then CS is released and done is called as if it had completed
+ * @retval Returns false if the driver refused the transaction
+ */
+bool dma_ring_queue(DmaRing_t *ring, spi_transaction_ext_t *t);
+
+/**
+ * @brief  Wait until the driver returned every queued transaction
+ */
+void dma_ring_wait(DmaRing_t *ring);
+
+// SPI driver callbacks, polling transactions carry no slot and are ignored
+void dma_ring_pre_callback(spi_transaction_t *t);
+void dma_ring_post_callback(spi_transaction_t *t);
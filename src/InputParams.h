@@ -10,6 +10,8 @@
 
 #pragma once
 
+#include <stdint.h>
+#include <stdbool.h>
 #include <freertos/queue.h>
 
 struct InputData {
@@ -21,8 +23,55 @@ struct InputData {
     int y;
 };
 
+// Events buffered per input device, a power of two keeps the index math cheap
+#ifndef INPUT_RING_SIZE
+#define INPUT_RING_SIZE     (32)
+#endif
+
+/*
+* Lock-free ring for one producer (the USB HID task) and one consumer
+* (the lvgl read callback). Neither side ever blocks, a full ring drops
+* the new event and counts it.
+* */
+struct InputRing {
+    struct InputData data[INPUT_RING_SIZE];
+    volatile uint32_t head;     // Written by the producer only
+    volatile uint32_t tail;     // Written by the consumer only
+    volatile uint32_t dropped;
+};
+
+static inline bool inputRingPush(struct InputRing *ring, const struct InputData *in)
+{
+    uint32_t head = ring->head;
+    if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= INPUT_RING_SIZE) {
+        ring->dropped++;
+        return false;
+    }
+    ring->data[head % INPUT_RING_SIZE] = *in;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static inline bool inputRingPop(struct InputRing *ring, struct InputData *out)
+{
+    uint32_t tail = ring->tail;
+    if (tail == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    *out = ring->data[tail % INPUT_RING_SIZE];
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static inline bool inputRingEmpty(struct InputRing *ring)
+{
+    return ring->tail == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+}
+
 struct InputParams {
-    QueueHandle_t queue;
+    QueueHandle_t queue;        // Shared queue, only used when the rings are NULL
     const void *icon;
+    struct InputRing *mouse;    // 'm' events
+    struct InputRing *keyboard; // 'k' events
 };
 
@@ -0,0 +1,217 @@
+/**
+ * @file      LV_DigitLabel.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2025  Shenzhen Xin Yuan Electronic Technology Co., Ltd
+ * @date      2025-03-18
+ * @note      Glyphs are true color images, drawing a character is a plain copy
+ *            without the font decompression and blending a label does.
+ */
+#include <Arduino.h>
+#include "LV_DigitLabel.h"
+
+#if LVGL_VERSION_MAJOR == 8
+
+#define DIGIT_LABEL_MAX_GLYPHS      (32)
+
+typedef struct __DigitLabel {
+    int8_t index[128];                          //Glyph of each ASCII character, -1 if not rendered
+    lv_img_dsc_t glyphs[DIGIT_LABEL_MAX_GLYPHS];
+    uint8_t *atlas;
+    char text[LV_DIGIT_LABEL_MAX_LEN + 1];
+} DigitLabel_t;
+
+static const lv_img_dsc_t *glyph_get(DigitLabel_t *label, char c)
+{
+    if (c < 0 || label->index[(uint8_t)c] < 0) {
+        return NULL;
+    }
+    return &label->glyphs[label->index[(uint8_t)c]];
+}
+
+static lv_coord_t cell_width(DigitLabel_t *label, char c)
+{
+    const lv_img_dsc_t *glyph = glyph_get(label, c);
+    return glyph ? glyph->header.w : 0;
+}
+
+static void render_glyph(const lv_font_t *font, char letter, lv_coord_t w, lv_coord_t h,
+                         lv_color_t color, lv_color_t bg_color, lv_color_t *dst)
+{
+    for (uint32_t i = 0; i < (uint32_t)w * h; i++) {
+        dst[i] = bg_color;
+    }
+    lv_font_glyph_dsc_t g;
+    if (!lv_font_get_glyph_dsc(font, &g, letter, 0) || !g.box_w || !g.box_h) {
+        return;
+    }
+    const uint8_t *bitmap = lv_font_get_glyph_bitmap(font, letter);
+    if (!bitmap) {
+        return;
+    }
+
+    // Same placement as lvgl's letter drawing, centered in the cell
+    uint8_t bpp = g.bpp == 3 ? 4 : g.bpp;
+    uint32_t shade_max = (1U << bpp) - 1;
+    lv_coord_t x0 = (w - (lv_coord_t)g.adv_w) / 2 + g.ofs_x;
+    lv_coord_t y0 = (font->line_height - font->base_line) - g.box_h - g.ofs_y;
+    uint32_t bit = 0;
+    for (lv_coord_t y = 0; y < g.box_h; y++) {
+        for (lv_coord_t x = 0; x < g.box_w; x++, bit += bpp) {
+            uint32_t px = (bitmap[bit >> 3] >> (8 - bpp - (bit & 7))) & shade_max;
+            lv_coord_t dx = x0 + x;
+            lv_coord_t dy = y0 + y;
+            if (!px || dx < 0 || dx >= w || dy < 0 || dy >= h) {
+                continue;
+            }
+            dst[dy * w + dx] = lv_color_mix(color, bg_color, px * LV_OPA_COVER / shade_max);
+        }
+    }
+}
+
+static void digit_label_event(lv_event_t *e)
+{
+    lv_obj_t *obj = lv_event_get_target(e);
+    DigitLabel_t *label = (DigitLabel_t *)lv_obj_get_user_data(obj);
+    if (!label) {
+        return;
+    }
+
+    if (lv_event_get_code(e) == LV_EVENT_DELETE) {
+        free(label->atlas);
+        free(label);
+        lv_obj_set_user_data(obj, NULL);
+        return;
+    }
+
+    // LV_EVENT_DRAW_MAIN, cells outside the invalidated area are clipped away by lv_draw_img
+    lv_draw_ctx_t *draw_ctx = lv_event_get_draw_ctx(e);
+    lv_draw_img_dsc_t img_dsc;
+    lv_draw_img_dsc_init(&img_dsc);
+    lv_area_t cell;
+    cell.x1 = obj->coords.x1;
+    cell.y1 = obj->coords.y1;
+    for (const char *c = label->text; *c; c++) {
+        const lv_img_dsc_t *glyph = glyph_get(label, *c);
+        if (!glyph) {
+            continue;
+        }
+        cell.x2 = cell.x1 + glyph->header.w - 1;
+        cell.y2 = cell.y1 + glyph->header.h - 1;
+        if (_lv_area_is_on(&cell, draw_ctx->clip_area)) {
+            lv_draw_img(draw_ctx, &img_dsc, &cell, glyph);
+        }
+        cell.x1 = cell.x2 + 1;
+    }
+}
+
+lv_obj_t *createLvglDigitLabel(lv_obj_t *parent, const lv_font_t *font, lv_color_t color,
+                               lv_color_t bg_color, const char *charset)
+{
+    DigitLabel_t *label = (DigitLabel_t *)calloc(1, sizeof(DigitLabel_t));
+    if (!label) {
+        return NULL;
+    }
+    memset(label->index, -1, sizeof(label->index));
+
+    // Digits get the widest digit's advance, so "1" and "8" take the same space
+    lv_coord_t h = lv_font_get_line_height(font);
+    lv_coord_t digit_w = 0;
+    for (char c = '0'; c <= '9'; c++) {
+        lv_coord_t adv = lv_font_get_glyph_width(font, c, 0);
+        digit_w = adv > digit_w ? adv : digit_w;
+    }
+
+    uint32_t atlas_w = 0;
+    uint8_t count = 0;
+    for (const char *c = charset; *c && count < DIGIT_LABEL_MAX_GLYPHS; c++) {
+        if (*c < 0 || label->index[(uint8_t)*c] >= 0) {
+            continue;
+        }
+        lv_img_dsc_t *glyph = &label->glyphs[count];
+        glyph->header.always_zero = 0;
+        glyph->header.cf = LV_IMG_CF_TRUE_COLOR;
+        glyph->header.w = (*c >= '0' && *c <= '9') ? digit_w : lv_font_get_glyph_width(font, *c, 0);
+        glyph->header.h = h;
+        glyph->data_size = glyph->header.w * h * sizeof(lv_color_t);
+        label->index[(uint8_t)*c] = count++;
+        atlas_w += glyph->header.w;
+    }
+
+    label->atlas = (uint8_t *)ps_malloc(atlas_w * h * sizeof(lv_color_t));
+    if (!label->atlas) {
+        log_e("No PSRAM for the digit label atlas");
+        free(label);
+        return NULL;
+    }
+    uint8_t *data = label->atlas;
+    for (const char *c = charset; *c; c++) {
+        const lv_img_dsc_t *glyph = glyph_get(label, *c);
+        if (!glyph || glyph->data) {
+            continue;
+        }
+        lv_img_dsc_t *dst = &label->glyphs[label->index[(uint8_t)*c]];
+        render_glyph(font, *c, dst->header.w, h, color, bg_color, (lv_color_t *)data);
+        dst->data = data;
+        data += dst->data_size;
+    }
+
+    lv_obj_t *obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(obj);
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_size(obj, 0, h);
+    lv_obj_set_user_data(obj, label);
+    lv_obj_add_event_cb(obj, digit_label_event, LV_EVENT_DRAW_MAIN, NULL);
+    lv_obj_add_event_cb(obj, digit_label_event, LV_EVENT_DELETE, NULL);
+    return obj;
+}
+
+void setLvglDigitLabelText(lv_obj_t *obj, const char *text)
+{
+    DigitLabel_t *label = obj ? (DigitLabel_t *)lv_obj_get_user_data(obj) : NULL;
+    if (!label || !text) {
+        return;
+    }
+    char next[LV_DIGIT_LABEL_MAX_LEN + 1];
+    strncpy(next, text, LV_DIGIT_LABEL_MAX_LEN);
+    next[LV_DIGIT_LABEL_MAX_LEN] = '\0';
+
+    // A different layout (length or a character of another width) redraws everything
+    size_t len = strlen(next);
+    bool relayout = len != strlen(label->text);
+    for (size_t i = 0; i < len && !relayout; i++) {
+        relayout = cell_width(label, next[i]) != cell_width(label, label->text[i]);
+    }
+    if (relayout) {
+        lv_coord_t w = 0;
+        for (size_t i = 0; i < len; i++) {
+            w += cell_width(label, next[i]);
+        }
+        strcpy(label->text, next);
+        lv_obj_set_width(obj, w);
+        lv_obj_invalidate(obj);
+        return;
+    }
+
+    // lv_obj_invalidate_area() grows every area by 5 pixels, into the neighbouring
+    // digits and the rows around the label, so the cells go to the display directly
+    bool visible = lv_obj_is_visible(obj);
+    lv_disp_t *disp = lv_obj_get_disp(obj);
+    lv_area_t cell, clipped;
+    cell.x1 = obj->coords.x1;
+    cell.y1 = obj->coords.y1;
+    cell.y2 = obj->coords.y2;
+    for (size_t i = 0; i < len && visible; i++) {
+        lv_coord_t w = cell_width(label, next[i]);
+        if (next[i] != label->text[i] && w) {
+            cell.x2 = cell.x1 + w - 1;
+            if (_lv_area_intersect(&clipped, &cell, &obj->coords)) {
+                _lv_inv_area(disp, &clipped);
+            }
+        }
+        cell.x1 += w;
+    }
+    strcpy(label->text, next);
+}
+
+#endif
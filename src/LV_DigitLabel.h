@@ -0,0 +1,43 @@
+/**
+ * @file      LV_DigitLabel.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2025  Shenzhen Xin Yuan Electronic Technology Co., Ltd
+ * @date      2025-03-18
+ * @note      Label for clocks and counters on lvgl 8. The glyphs are rendered once
+ *            into an RGB565 atlas, a new text only redraws the characters that changed.
+ */
+#pragma once
+
+#include <lvgl.h>
+
+// Characters rendered into the atlas when no charset is given
+#ifndef LV_DIGIT_LABEL_CHARSET
+#define LV_DIGIT_LABEL_CHARSET      "0123456789:.-/ "
+#endif
+
+// Longest text shown, longer text is truncated
+#ifndef LV_DIGIT_LABEL_MAX_LEN
+#define LV_DIGIT_LABEL_MAX_LEN      (16)
+#endif
+
+/**
+ * @brief  Create a digit label
+ * @note   Digits share one cell width so the text does not shift while it counts.
+ *         The glyphs are drawn over bg_color, so it must match what is behind the label.
+ *         The object's user data is used by the label
+ * @param  parent: Parent object
+ * @param  font: Font the charset is rendered with
+ * @param  color: Text color
+ * @param  bg_color: Color behind the text
+ * @param  charset: Characters the text can contain, others are left blank
+ * @retval The label, NULL if the atlas cannot be allocated
+ */
+lv_obj_t *createLvglDigitLabel(lv_obj_t *parent, const lv_font_t *font, lv_color_t color,
+                               lv_color_t bg_color, const char *charset = LV_DIGIT_LABEL_CHARSET);
+
+/**
+ * @brief  Set the text, only the changed characters are invalidated
+ * @note   Call from the lvgl task, other tasks use postLvglTextCall(label, setLvglDigitLabelText, text)
+ */
+void setLvglDigitLabelText(lv_obj_t *label, const char *text);
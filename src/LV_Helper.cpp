@@ -7,11 +7,18 @@
  * @note      Adapt to lvgl 8 version
  */
 #include <Arduino.h>
+#include <esp_timer.h>
 #include "LV_Helper.h"
 
 
 #if LVGL_VERSION_MAJOR == 8
 
+// Pixel cost of one extra window setup, two areas are merged when the
+// pixels wasted by their bounding box are cheaper than another transfer
+#ifndef LV_HELPER_AREA_JOIN_PENALTY
+#define LV_HELPER_AREA_JOIN_PENALTY     (1024)
+#endif
+
 static lv_disp_draw_buf_t draw_buf;
 static lv_disp_drv_t disp_drv;
 static lv_indev_drv_t  indev_drv;
@@ -20,31 +27,139 @@ static lv_indev_t  *kb_indev = NULL;
 static lv_indev_drv_t indev_mouse;
 static lv_indev_drv_t indev_keypad;
 static struct InputParams params_copy;
+static bool async_flush = false;
+static bool frame_start = true;
+static LvHelperStats_t helper_stats;
+static int64_t render_mark_us;
+static int64_t frame_start_us;
+static int64_t flush_start_us;
+static volatile bool flush_last;
+
+static const char *const buffering_name[] = {
+    "PSRAM full", "PSRAM direct", "SRAM stripes", "Hybrid",
+};
+
+// Start each refresh cycle on a TE edge, does nothing when vsync is disabled
+static inline void disp_wait_vsync( lv_disp_drv_t *disp_drv )
+{
+    if (frame_start) {
+        static_cast<LilyGo_Display *>(disp_drv->user_data)->waitVsync();
+    }
+    frame_start = lv_disp_flush_is_last(disp_drv);
+}
+
+static inline void stats_flush_begin( lv_disp_drv_t *disp_drv, uint32_t pixels )
+{
+    int64_t now = esp_timer_get_time();
+    helper_stats.renderUs += now - render_mark_us;
+    helper_stats.flushCount++;
+    helper_stats.pixelCount += pixels;
+    flush_start_us = now;
+    flush_last = lv_disp_flush_is_last(disp_drv);
+}
+
+// Called from the SPI interrupt in asynchronous mode
+static void IRAM_ATTR disp_flush_done( lv_disp_drv_t *disp_drv )
+{
+    int64_t now = esp_timer_get_time();
+    helper_stats.flushUs += now - flush_start_us;
+    if (flush_last) {
+        helper_stats.frameCount++;
+        helper_stats.frameUs += now - frame_start_us;
+    }
+    lv_disp_flush_ready( disp_drv );
+}
 
 /* Display flushing */
 static void disp_flush( lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p )
 {
     uint32_t w = ( area->x2 - area->x1 + 1 );
     uint32_t h = ( area->y2 - area->y1 + 1 );
+    stats_flush_begin(disp_drv, w * h);
+    disp_wait_vsync(disp_drv);
     static_cast<LilyGo_Display *>(disp_drv->user_data)->pushColors(area->x1, area->y1, w, h, (uint16_t *)color_p);
-    lv_disp_flush_ready( disp_drv );
+    disp_flush_done( disp_drv );
+    render_mark_us = esp_timer_get_time();
 }
 
 static void disp_flushDMA( lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p )
 {
     uint32_t w = ( area->x2 - area->x1 + 1 );
     uint32_t h = ( area->y2 - area->y1 + 1 );
-    static_cast<LilyGo_Display *>(disp_drv->user_data)->setAddrWindow(area->x1, area->y1, area->x2, area->y2);
-    static_cast<LilyGo_Display *>(disp_drv->user_data)->pushColorsDMA((uint16_t *)color_p, w * h);
+    stats_flush_begin(disp_drv, w * h);
+    disp_wait_vsync(disp_drv);
+    static_cast<LilyGo_Display *>(disp_drv->user_data)->pushColorsDMA(area->x1, area->y1, w, h, (uint16_t *)color_p);
 
-    lv_disp_flush_ready( disp_drv );
+    // In asynchronous mode the SPI interrupt signals the end of the transfer
+    if (!async_flush) {
+        disp_flush_done( disp_drv );
+    }
+    render_mark_us = esp_timer_get_time();
+}
+
+/*
+* In direct mode color_p is the whole frame and every invalidated area is
+* rendered in place. Nothing is sent until the last area, then the rows
+* covering all of them go out as one full width window, which keeps the
+* source contiguous and completes with a single callback.
+* */
+static void disp_flushDirect( lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p )
+{
+    if (!lv_disp_flush_is_last(disp_drv)) {
+        lv_disp_flush_ready( disp_drv );
+        return;
+    }
+
+    lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+    lv_coord_t y1 = area->y1;
+    lv_coord_t y2 = area->y2;
+    if (disp && disp->driver == disp_drv && disp->inv_p) {
+        y1 = disp_drv->ver_res;
+        y2 = -1;
+        for (uint16_t i = 0; i < disp->inv_p; i++) {
+            if (disp->inv_area_joined[i]) {
+                continue;
+            }
+            y1 = LV_MIN(y1, disp->inv_areas[i].y1);
+            y2 = LV_MAX(y2, disp->inv_areas[i].y2);
+        }
+    }
+    if (y2 < y1) {
+        lv_disp_flush_ready( disp_drv );
+        return;
+    }
+
+    uint32_t w = disp_drv->hor_res;
+    uint32_t h = y2 - y1 + 1;
+    stats_flush_begin(disp_drv, w * h);
+    disp_wait_vsync(disp_drv);
+    static_cast<LilyGo_Display *>(disp_drv->user_data)->pushColorsDMA(0, y1, w, h, (uint16_t *)(color_p + w * y1));
+    if (!async_flush) {
+        disp_flush_done( disp_drv );
+    }
+    render_mark_us = esp_timer_get_time();
+}
+
+static void IRAM_ATTR disp_flush_ready_cb(void *user_data)
+{
+    disp_flush_done((lv_disp_drv_t *)user_data);
 }
 
 /*Read the touchpad*/
 static void touchpad_read( lv_indev_drv_t *indev_driver, lv_indev_data_t *data )
 {
     static int16_t x, y;
-    uint8_t touched =   static_cast<LilyGo_Display *>(indev_driver->user_data)->getPoint(&x, &y, 1);
+    auto *board = static_cast<LilyGo_Display *>(indev_driver->user_data);
+    TouchSample_t sample;
+    // Drain the samples buffered by an interrupt driven reader, one per call
+    if (board->readTouchSample(&sample)) {
+        data->point.x = sample.x;
+        data->point.y = sample.y;
+        data->state = sample.pressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+        data->continue_reading = true;
+        return;
+    }
+    uint8_t touched = board->getPoint(&x, &y, 1);
     if ( touched ) {
         data->point.x = x;
         data->point.y = y;
@@ -58,6 +173,7 @@ static void touchpad_read( lv_indev_drv_t *indev_driver, lv_indev_data_t *data )
 #error "Please turn on PSRAM to OPI !"
 #else
 static lv_color_t *buf = NULL;
+static lv_color_t *buf1 = NULL;
 #endif
 
 #if LV_USE_LOG
@@ -72,18 +188,30 @@ static void mouse_read(lv_indev_drv_t *indev, lv_indev_data_t *data)
 {
     static int16_t last_x;
     static int16_t last_y;
+    static bool pressed;
     struct InputData msg;
     const lv_img_dsc_t *cur = (const lv_img_dsc_t *)params_copy.icon;
     uint16_t _maxX = lv_disp_get_hor_res(NULL) - cur->header.w;
     uint16_t _maxY = lv_disp_get_ver_res(NULL) - cur->header.h;
 
-    if (xQueueReceive(params_copy.queue, &msg, pdTICKS_TO_MS(30)) == pdPASS) {
-        if (msg.id == 'm') {
+    if (params_copy.mouse) {
+        // Only the latest position is used, a button change ends the batch so no click is lost
+        while (inputRingPop(params_copy.mouse, &msg)) {
             last_x = constrain(msg.x, 0, _maxX);
             last_y = constrain(msg.y, 0, _maxY);
-            data->state = (msg.left || msg.right) ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+            if ((msg.left || msg.right) != pressed) {
+                pressed = !pressed;
+                data->continue_reading = !inputRingEmpty(params_copy.mouse);
+                break;
+            }
         }
+    } else if (params_copy.queue && xQueuePeek(params_copy.queue, &msg, 0) == pdPASS && msg.id == 'm') {
+        xQueueReceive(params_copy.queue, &msg, 0);
+        last_x = constrain(msg.x, 0, _maxX);
+        last_y = constrain(msg.y, 0, _maxY);
+        pressed = msg.left || msg.right;
     }
+    data->state = pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
     data->point.x = last_x;
     data->point.y = last_y;
 }
@@ -91,17 +219,33 @@ static void mouse_read(lv_indev_drv_t *indev, lv_indev_data_t *data)
 static void keypad_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
 {
     static uint32_t last_key = 0;
-    uint32_t act_key ;
+    static bool key_down = false;
     struct InputData msg;
-    if (xQueueReceive(params_copy.queue, &msg, pdTICKS_TO_MS(30)) == pdPASS) {
-        if (msg.id == 'k') {
-            last_key =  msg.key;
-            data->key = msg.key;
-            data->state = LV_INDEV_STATE_PR;
-            return;
-        }
+
+    // Every key is reported pressed and then released, lvgl ignores a new key while one is held
+    if (key_down) {
+        key_down = false;
+        data->key = last_key;
+        data->state = LV_INDEV_STATE_RELEASED;
+        data->continue_reading = params_copy.keyboard && !inputRingEmpty(params_copy.keyboard);
+        return;
     }
-    data->state = LV_INDEV_STATE_REL;
+
+    bool received = false;
+    if (params_copy.keyboard) {
+        received = inputRingPop(params_copy.keyboard, &msg);
+    } else if (params_copy.queue && xQueuePeek(params_copy.queue, &msg, 0) == pdPASS && msg.id == 'k') {
+        received = xQueueReceive(params_copy.queue, &msg, 0) == pdPASS;
+    }
+    if (received) {
+        last_key = msg.key;
+        key_down = true;
+        data->key = last_key;
+        data->state = LV_INDEV_STATE_PRESSED;
+        data->continue_reading = true;
+        return;
+    }
+    data->state = LV_INDEV_STATE_RELEASED;
     data->key = last_key;
 }
 
@@ -119,7 +263,49 @@ static void lv_rounder_cb(lv_disp_drv_t *disp_drv, lv_area_t *area)
         area->y2++;
 }
 
-void beginLvglHelperDMA(LilyGo_Display &board, bool debug) {
+/*
+* lvgl only joins invalidated areas whose bounding box is smaller than the
+* two areas together, adjacent or nearly touching areas are kept apart and
+* each one costs a separate window setup. Join them here before rendering.
+* Areas are always merged into the later index so the last area lvgl has
+* already picked stays valid.
+* */
+static void lv_render_start_cb(lv_disp_drv_t *disp_drv)
+{
+    frame_start_us = render_mark_us = esp_timer_get_time();
+
+    lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+    if (!disp || disp->driver != disp_drv || disp_drv->full_refresh) {
+        return;
+    }
+
+    bool joined;
+    do {
+        joined = false;
+        for (uint16_t from = 0; from < disp->inv_p; from++) {
+            if (disp->inv_area_joined[from]) {
+                continue;
+            }
+            for (uint16_t in = from + 1; in < disp->inv_p; in++) {
+                if (disp->inv_area_joined[in]) {
+                    continue;
+                }
+                lv_area_t area;
+                _lv_area_join(&area, &disp->inv_areas[in], &disp->inv_areas[from]);
+                uint32_t sum = lv_area_get_size(&disp->inv_areas[in]) + lv_area_get_size(&disp->inv_areas[from]);
+                if (lv_area_get_size(&area) <= sum + LV_HELPER_AREA_JOIN_PENALTY) {
+                    lv_area_copy(&disp->inv_areas[in], &area);
+                    disp->inv_area_joined[from] = 1;
+                    joined = true;
+                    break;
+                }
+            }
+        }
+    } while (joined);
+}
+
+bool beginLvglHelper(LilyGo_Display &board, LvHelperBuffering_t policy, uint16_t lines, bool debug)
+{
     lv_init();
 
 #if LV_USE_LOG
@@ -128,34 +314,82 @@ void beginLvglHelperDMA(LilyGo_Display &board, bool debug) {
     }
 #endif
 
-    size_t lv_buffer_size = (board.width() * board.height() / 10) * sizeof(lv_color_t);
-
-    lv_color_t *buf1 = (lv_color_t *)heap_caps_malloc(lv_buffer_size, MALLOC_CAP_DMA);
-    lv_color_t *buf2 = (lv_color_t *)heap_caps_malloc(lv_buffer_size, MALLOC_CAP_DMA);
+    bool full_refresh = board.needFullRefresh();
+    uint32_t caps = MALLOC_CAP_SPIRAM;
+    bool dual = true;
+    void (*flush_cb)(lv_disp_drv_t *, const lv_area_t *, lv_color_t *) = disp_flushDMA;
+
+    switch (policy) {
+    case LV_HELPER_BUF_PSRAM_FULL:
+        lines = board.height();
+        dual = false;
+        flush_cb = disp_flush;
+        break;
+    case LV_HELPER_BUF_PSRAM_DIRECT:
+        lines = board.height();
+        if (!full_refresh) {
+            flush_cb = disp_flushDirect;
+        }
+        break;
+    case LV_HELPER_BUF_SRAM_STRIPES:
+        if (!lines) {
+            lines = board.height() / 10;
+        }
+        // A full refresh needs a whole frame, which does not fit into internal RAM
+        if (full_refresh) {
+            log_w("Full refresh board, the stripes are placed in PSRAM");
+        } else {
+            caps = MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL;
+        }
+        break;
+    case LV_HELPER_BUF_HYBRID:
+    default:
+        if (!lines) {
+            lines = board.height();
+        }
+        break;
+    }
 
-    assert (buf1 && buf2);
+    // The rounder keeps areas on even rows, so must the buffer
+    lines = (lines + 1) & ~1;
+    if (full_refresh || lines > board.height()) {
+        lines = board.height();
+    }
 
-    if (!esp_ptr_dma_capable(buf1) || !esp_ptr_dma_capable(buf2)) {
-        Serial.println("Error: Buffers are not DMA-capable!");
+    uint32_t buffer_pixels = (uint32_t)board.width() * lines;
+    buf = (lv_color_t *)heap_caps_malloc(buffer_pixels * sizeof(lv_color_t), caps);
+    buf1 = dual ? (lv_color_t *)heap_caps_malloc(buffer_pixels * sizeof(lv_color_t), caps) : NULL;
+    if (!buf || (dual && !buf1)) {
+        log_e("Failed to allocate the %s buffers, %u lines", getLvglHelperBufferingName(policy), lines);
+        heap_caps_free(buf);
+        heap_caps_free(buf1);
+        buf = buf1 = NULL;
+        return false;
     }
 
-    lv_disp_draw_buf_init(&draw_buf, buf1, buf2, board.width() * board.height() / 10);
+    lv_disp_draw_buf_init(&draw_buf, buf, buf1, buffer_pixels);
 
     /*Initialize the display*/
     lv_disp_drv_init( &disp_drv );
     /* display resolution */
     disp_drv.hor_res = board.width();
     disp_drv.ver_res = board.height();
-    disp_drv.flush_cb = disp_flushDMA;
+    disp_drv.flush_cb = flush_cb;
     disp_drv.draw_buf = &draw_buf;
-    bool full_refresh = board.needFullRefresh();
     disp_drv.full_refresh = full_refresh;
+    disp_drv.direct_mode = flush_cb == disp_flushDirect;
     disp_drv.user_data = &board;
+    disp_drv.render_start_cb = lv_render_start_cb;
     if (!full_refresh) {
         disp_drv.rounder_cb = lv_rounder_cb;
     }
     lv_disp_drv_register( &disp_drv );
 
+    // Let lvgl render into the second buffer while the first one is still being sent
+    if (flush_cb != disp_flush) {
+        async_flush = board.setFlushReadyCallback(disp_flush_ready_cb, &disp_drv);
+    }
+
     if (board.hasTouch()) {
         lv_indev_drv_init( &indev_drv );
         indev_drv.type = LV_INDEV_TYPE_POINTER;
@@ -165,49 +399,45 @@ void beginLvglHelperDMA(LilyGo_Display &board, bool debug) {
     }
 
     lv_group_set_default(lv_group_create());
+
+    resetLvglHelperStats();
+    return true;
 }
 
-void beginLvglHelper(LilyGo_Display &board, bool debug)
+void beginLvglHelperDMA(LilyGo_Display &board, bool debug)
 {
-
-    lv_init();
-
-#if LV_USE_LOG
-    if (debug) {
-        lv_log_register_print_cb(lv_log_print_g_cb);
+    if (!beginLvglHelper(board, LV_HELPER_BUF_SRAM_STRIPES, 0, debug)) {
+        log_e("LVGL helper not started");
     }
-#endif
-
-    size_t lv_buffer_size = board.width() * board.height() * sizeof(lv_color_t);
-    buf = (lv_color_t *)ps_malloc(lv_buffer_size);
-    assert(buf);
+}
 
-    lv_disp_draw_buf_init( &draw_buf, buf, NULL, board.width() * board.height());
+void beginLvglHelper(LilyGo_Display &board, bool debug)
+{
+    if (!beginLvglHelper(board, LV_HELPER_BUF_PSRAM_FULL, 0, debug)) {
+        log_e("LVGL helper not started");
+    }
+}
 
-    /*Initialize the display*/
-    lv_disp_drv_init( &disp_drv );
-    /* display resolution */
-    disp_drv.hor_res = board.width();
-    disp_drv.ver_res = board.height();
-    disp_drv.flush_cb = disp_flush;
-    disp_drv.draw_buf = &draw_buf;
-    bool full_refresh = board.needFullRefresh();
-    disp_drv.full_refresh = full_refresh;
-    disp_drv.user_data = &board;
-    if (!full_refresh) {
-        disp_drv.rounder_cb = lv_rounder_cb;
+const char *getLvglHelperBufferingName(LvHelperBuffering_t policy)
+{
+    if (policy > LV_HELPER_BUF_HYBRID) {
+        return "Unknown";
     }
-    lv_disp_drv_register( &disp_drv );
+    return buffering_name[policy];
+}
 
-    if (board.hasTouch()) {
-        lv_indev_drv_init( &indev_drv );
-        indev_drv.type = LV_INDEV_TYPE_POINTER;
-        indev_drv.read_cb = touchpad_read;
-        indev_drv.user_data = &board;
-        lv_indev_drv_register( &indev_drv );
+void getLvglHelperStats(LvHelperStats_t *stats)
+{
+    if (!stats) {
+        return;
     }
+    memcpy(stats, &helper_stats, sizeof(LvHelperStats_t));
+}
 
-    lv_group_set_default(lv_group_create());
+void resetLvglHelperStats()
+{
+    memset(&helper_stats, 0, sizeof(helper_stats));
+    frame_start_us = render_mark_us = esp_timer_get_time();
 }
 
 void beginLvglInputDevice(struct InputParams prams)
@@ -13,8 +13,42 @@
 #include "InputParams.h"
 
 
+// Where lvgl renders and how the rendered pixels reach the panel
+typedef enum {
+    LV_HELPER_BUF_PSRAM_FULL,       //One full frame in PSRAM, blocking flush, default of beginLvglHelper
+    LV_HELPER_BUF_PSRAM_DIRECT,     //Two full frames in PSRAM, direct mode, only changed rows are sent
+    LV_HELPER_BUF_SRAM_STRIPES,     //Two stripes in internal DMA RAM, asynchronous flush, default of beginLvglHelperDMA
+    LV_HELPER_BUF_HYBRID,           //Two buffers in PSRAM, the DMA streams them through internal bounce chunks
+} LvHelperBuffering_t;
+
+typedef struct __LvHelperStats {
+    uint32_t frameCount;
+    uint32_t flushCount;
+    uint64_t pixelCount;
+    uint64_t renderUs;              //Render start or the end of a flush call until the next flush call
+    uint64_t flushUs;               //Flush call until the transfer is done
+    uint64_t frameUs;               //Render start until the last area of the frame is sent
+} LvHelperStats_t;
+
 void beginLvglHelper(LilyGo_Display &board, bool debug = false);
 void beginLvglHelperDMA(LilyGo_Display &board, bool debug = false);
+
+/**
+ * @brief  Register the display with a selectable buffering policy
+ * @note   Boards that need a full refresh always get full frame buffers
+ * @param  board: Display to register
+ * @param  policy: Buffer placement, see LvHelperBuffering_t
+ * @param  lines: Buffer height for SRAM_STRIPES and HYBRID, rounded up to even,
+ *                0 selects 1/10 of the screen for stripes and the full screen for hybrid
+ * @param  debug: Print the lvgl log to Serial
+ * @retval Returns false if the buffers cannot be allocated
+ */
+bool beginLvglHelper(LilyGo_Display &board, LvHelperBuffering_t policy, uint16_t lines = 0, bool debug = false);
+
+const char *getLvglHelperBufferingName(LvHelperBuffering_t policy);
+void getLvglHelperStats(LvHelperStats_t *stats);
+void resetLvglHelperStats();
+
 void beginLvglInputDevice(struct InputParams prams);
 
 
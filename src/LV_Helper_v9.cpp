@@ -7,7 +7,9 @@
  * @note      Adapt to lvgl 9 version
  */
 #include <Arduino.h>
+#include <esp_timer.h>
 #include "LV_Helper.h"
+#include "PixelKernel.h"
 
 #if LVGL_VERSION_MAJOR == 9
 
@@ -23,15 +25,125 @@ static lv_color16_t *buf1  = NULL;
 static lv_indev_t  *mouse_indev = NULL;
 static lv_indev_t  *kb_indev = NULL;
 static struct InputParams params_copy;
+static bool swap_in_driver = false;
+static bool async_flush = false;
+static bool frame_start = true;
+static LvHelperStats_t helper_stats;
+static int64_t render_mark_us;
+static int64_t frame_start_us;
+static int64_t flush_start_us;
+static volatile bool flush_last;
+
+static const char *const buffering_name[] = {
+    "PSRAM full", "PSRAM direct", "SRAM stripes", "Hybrid",
+};
+
+// Start each refresh cycle on a TE edge, does nothing when vsync is disabled
+static inline void disp_wait_vsync( lv_display_t *disp_drv )
+{
+    if (frame_start) {
+        ((LilyGo_Display *)lv_display_get_user_data(disp_drv))->waitVsync();
+    }
+    frame_start = lv_display_flush_is_last(disp_drv);
+}
+
+static inline void stats_flush_begin( lv_display_t *disp_drv, uint32_t pixels )
+{
+    int64_t now = esp_timer_get_time();
+    helper_stats.renderUs += now - render_mark_us;
+    helper_stats.flushCount++;
+    helper_stats.pixelCount += pixels;
+    flush_start_us = now;
+    flush_last = lv_display_flush_is_last(disp_drv);
+}
+
+// Called from the SPI interrupt in asynchronous mode
+static void IRAM_ATTR disp_flush_done( lv_display_t *disp_drv )
+{
+    int64_t now = esp_timer_get_time();
+    helper_stats.flushUs += now - flush_start_us;
+    if (flush_last) {
+        helper_stats.frameCount++;
+        helper_stats.frameUs += now - frame_start_us;
+    }
+    lv_display_flush_ready( disp_drv );
+}
 
 static void disp_flush( lv_display_t *disp_drv, const lv_area_t *area, uint8_t *color_p)
 {
     uint32_t w = ( area->x2 - area->x1 + 1 );
     uint32_t h = ( area->y2 - area->y1 + 1 );
     auto *plane = (LilyGo_Display *)lv_display_get_user_data(disp_drv);
-    lv_draw_sw_rgb565_swap(color_p, w * h * 2);
+    stats_flush_begin(disp_drv, w * h);
+    disp_wait_vsync(disp_drv);
+    // lvgl 9 renders native RGB565, let the driver swap it on the way to the bus when it can
+    if (!swap_in_driver) {
+        pixel_swap((uint16_t *)color_p, (uint16_t *)color_p, w * h);
+    }
     plane->pushColors(area->x1, area->y1, w, h, (uint16_t *)color_p);
-    lv_display_flush_ready( disp_drv );
+    disp_flush_done( disp_drv );
+    render_mark_us = esp_timer_get_time();
+}
+
+/*
+* The partial buffers are not read back by lvgl, so a swap done here can stay.
+* The transfer runs while lvgl renders the next area into the other buffer.
+* */
+static void disp_flushDMA( lv_display_t *disp_drv, const lv_area_t *area, uint8_t *color_p)
+{
+    uint32_t w = ( area->x2 - area->x1 + 1 );
+    uint32_t h = ( area->y2 - area->y1 + 1 );
+    auto *plane = (LilyGo_Display *)lv_display_get_user_data(disp_drv);
+    stats_flush_begin(disp_drv, w * h);
+    disp_wait_vsync(disp_drv);
+    if (!swap_in_driver) {
+        pixel_swap((uint16_t *)color_p, (uint16_t *)color_p, w * h);
+    }
+    plane->pushColorsDMA(area->x1, area->y1, w, h, (uint16_t *)color_p);
+
+    // In asynchronous mode the SPI interrupt signals the end of the transfer
+    if (!async_flush) {
+        disp_flush_done( disp_drv );
+    }
+    render_mark_us = esp_timer_get_time();
+}
+
+/*
+* In direct mode the buffer keeps the whole frame, send the full width rows
+* of the area so the source stays contiguous. The frame is the reference
+* for the next render, a swap done here has to be undone after sending,
+* so the transfer is only left running when the driver swaps.
+* */
+static void disp_flushDirect( lv_display_t *disp_drv, const lv_area_t *area, uint8_t *color_p)
+{
+    uint32_t w = lv_display_get_horizontal_resolution(disp_drv);
+    uint32_t h = ( area->y2 - area->y1 + 1 );
+    if (color_p != (uint8_t *)buf && color_p != (uint8_t *)buf1) {
+        // Already points at the area
+        disp_flush(disp_drv, area, color_p);
+        return;
+    }
+    auto *plane = (LilyGo_Display *)lv_display_get_user_data(disp_drv);
+    uint16_t *rows = (uint16_t *)color_p + w * area->y1;
+    stats_flush_begin(disp_drv, w * h);
+    disp_wait_vsync(disp_drv);
+    if (swap_in_driver) {
+        plane->pushColorsDMA(0, area->y1, w, h, rows);
+        if (!async_flush) {
+            disp_flush_done( disp_drv );
+        }
+    } else {
+        pixel_swap(rows, rows, w * h);
+        plane->pushColors(0, area->y1, w, h, rows);
+        pixel_swap(rows, rows, w * h);
+        disp_flush_done( disp_drv );
+    }
+    render_mark_us = esp_timer_get_time();
+}
+
+static void IRAM_ATTR disp_flush_ready_cb(void *user_data)
+{
+    disp_flush_done((lv_display_t *)user_data);
 }
 
 /*Read the touchpad*/
@@ -39,6 +151,15 @@ static void touchpad_read( lv_indev_t *indev, lv_indev_data_t *data )
 {
     static int16_t x, y;
     auto *plane = (LilyGo_Display *)lv_indev_get_user_data(indev);
+    TouchSample_t sample;
+    // Drain the samples buffered by an interrupt driven reader, one per call
+    if (plane->readTouchSample(&sample)) {
+        data->point.x = sample.x;
+        data->point.y = sample.y;
+        data->state = sample.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+        data->continue_reading = true;
+        return;
+    }
     uint8_t touched = plane->getPoint(&x, &y, 1);
     if ( touched ) {
         data->point.x = x;
@@ -58,18 +179,30 @@ static void mouse_read( lv_indev_t *indev, lv_indev_data_t *data )
 {
     static int16_t last_x;
     static int16_t last_y;
+    static bool pressed;
     struct InputData msg;
     const lv_img_dsc_t *cur = (const lv_img_dsc_t *)params_copy.icon;
     uint16_t _maxX = lv_disp_get_hor_res(NULL) - cur->header.w;
     uint16_t _maxY = lv_disp_get_ver_res(NULL) - cur->header.h;
 
-    if (xQueueReceive(params_copy.queue, &msg, pdTICKS_TO_MS(30)) == pdPASS) {
-        if (msg.id == 'm') {
+    if (params_copy.mouse) {
+        // Only the latest position is used, a button change ends the batch so no click is lost
+        while (inputRingPop(params_copy.mouse, &msg)) {
             last_x = constrain(msg.x, 0, _maxX);
             last_y = constrain(msg.y, 0, _maxY);
-            data->state = (msg.left || msg.right) ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+            if ((msg.left || msg.right) != pressed) {
+                pressed = !pressed;
+                data->continue_reading = !inputRingEmpty(params_copy.mouse);
+                break;
+            }
         }
+    } else if (params_copy.queue && xQueuePeek(params_copy.queue, &msg, 0) == pdPASS && msg.id == 'm') {
+        xQueueReceive(params_copy.queue, &msg, 0);
+        last_x = constrain(msg.x, 0, _maxX);
+        last_y = constrain(msg.y, 0, _maxY);
+        pressed = msg.left || msg.right;
     }
+    data->state = pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
     data->point.x = last_x;
     data->point.y = last_y;
 }
@@ -77,20 +210,41 @@ static void mouse_read( lv_indev_t *indev, lv_indev_data_t *data )
 static void keypad_read( lv_indev_t *indev, lv_indev_data_t *data )
 {
     static uint32_t last_key = 0;
-    uint32_t act_key ;
+    static bool key_down = false;
     struct InputData msg;
-    if (xQueueReceive(params_copy.queue, &msg, pdTICKS_TO_MS(30)) == pdPASS) {
-        if (msg.id == 'k') {
-            last_key =  msg.key;
-            data->key = msg.key;
-            data->state = LV_INDEV_STATE_PR;
-            return;
-        }
+
+    // Every key is reported pressed and then released, lvgl ignores a new key while one is held
+    if (key_down) {
+        key_down = false;
+        data->key = last_key;
+        data->state = LV_INDEV_STATE_RELEASED;
+        data->continue_reading = params_copy.keyboard && !inputRingEmpty(params_copy.keyboard);
+        return;
     }
-    data->state = LV_INDEV_STATE_REL;
+
+    bool received = false;
+    if (params_copy.keyboard) {
+        received = inputRingPop(params_copy.keyboard, &msg);
+    } else if (params_copy.queue && xQueuePeek(params_copy.queue, &msg, 0) == pdPASS && msg.id == 'k') {
+        received = xQueueReceive(params_copy.queue, &msg, 0) == pdPASS;
+    }
+    if (received) {
+        last_key = msg.key;
+        key_down = true;
+        data->key = last_key;
+        data->state = LV_INDEV_STATE_PRESSED;
+        data->continue_reading = true;
+        return;
+    }
+    data->state = LV_INDEV_STATE_RELEASED;
     data->key = last_key;
 }
 
+static void lv_render_start_cb(lv_event_t *e)
+{
+    frame_start_us = render_mark_us = esp_timer_get_time();
+}
+
 static void lv_rounder_cb(lv_event_t *e)
 {
     lv_area_t *area = (lv_area_t *)lv_event_get_param(e);
@@ -104,7 +258,7 @@ static void lv_rounder_cb(lv_event_t *e)
         area->y2++;
 }
 
-void beginLvglHelper(LilyGo_Display &board, bool debug)
+bool beginLvglHelper(LilyGo_Display &board, LvHelperBuffering_t policy, uint16_t lines, bool debug)
 {
 
     lv_init();
@@ -115,27 +269,82 @@ void beginLvglHelper(LilyGo_Display &board, bool debug)
     }
 #endif
 
-    size_t lv_buffer_size = board.width() * board.height() * sizeof(lv_color16_t);
+    bool full_refresh = board.needFullRefresh();
+    uint32_t caps = MALLOC_CAP_SPIRAM;
+    bool dual = true;
+    lv_display_render_mode_t mode = full_refresh ? LV_DISPLAY_RENDER_MODE_FULL : LV_DISPLAY_RENDER_MODE_PARTIAL;
+    lv_display_flush_cb_t flush_cb = disp_flushDMA;
 
-    buf = (lv_color16_t *)ps_malloc(lv_buffer_size);
-    assert(buf);
+    switch (policy) {
+    case LV_HELPER_BUF_PSRAM_FULL:
+        lines = board.height();
+        dual = false;
+        flush_cb = disp_flush;
+        break;
+    case LV_HELPER_BUF_PSRAM_DIRECT:
+        lines = board.height();
+        if (!full_refresh) {
+            mode = LV_DISPLAY_RENDER_MODE_DIRECT;
+            flush_cb = disp_flushDirect;
+        }
+        break;
+    case LV_HELPER_BUF_SRAM_STRIPES:
+        if (!lines) {
+            lines = board.height() / 10;
+        }
+        // A full refresh needs a whole frame, which does not fit into internal RAM
+        if (full_refresh) {
+            log_w("Full refresh board, the stripes are placed in PSRAM");
+        } else {
+            caps = MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL;
+        }
+        break;
+    case LV_HELPER_BUF_HYBRID:
+    default:
+        if (!lines) {
+            lines = board.height();
+        }
+        break;
+    }
+
+    // The rounder keeps areas on even rows, so must the buffer
+    lines = (lines + 1) & ~1;
+    if (full_refresh || lines > board.height()) {
+        lines = board.height();
+    }
+
+    size_t lv_buffer_size = (size_t)board.width() * lines * sizeof(lv_color16_t);
 
-    buf1 = (lv_color16_t *)ps_malloc(lv_buffer_size);
-    assert(buf1);
+    buf = (lv_color16_t *)heap_caps_malloc(lv_buffer_size, caps);
+    buf1 = dual ? (lv_color16_t *)heap_caps_malloc(lv_buffer_size, caps) : NULL;
+    if (!buf || (dual && !buf1)) {
+        log_e("Failed to allocate the %s buffers, %u lines", getLvglHelperBufferingName(policy), lines);
+        heap_caps_free(buf);
+        heap_caps_free(buf1);
+        buf = buf1 = NULL;
+        return false;
+    }
 
     disp_drv = lv_display_create(board.width(), board.height());
 
-    if (board.needFullRefresh()) {
-        lv_display_set_buffers(disp_drv, buf, buf1, lv_buffer_size, LV_DISPLAY_RENDER_MODE_FULL);
-    } else {
-        lv_display_set_buffers(disp_drv, buf, buf1, lv_buffer_size, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_buffers(disp_drv, buf, buf1, lv_buffer_size, mode);
+    if (!full_refresh) {
         lv_display_add_event_cb(disp_drv, lv_rounder_cb, LV_EVENT_INVALIDATE_AREA, NULL);
     }
+    lv_display_add_event_cb(disp_drv, lv_render_start_cb, LV_EVENT_RENDER_START, NULL);
 
     lv_display_set_color_format(disp_drv, LV_COLOR_FORMAT_RGB565);
-    lv_display_set_flush_cb(disp_drv, disp_flush);
+    swap_in_driver = board.setSwapBytes(true);
+    lv_display_set_flush_cb(disp_drv, flush_cb);
     lv_display_set_user_data(disp_drv, &board);
 
+    // Let lvgl render into the second buffer while the first one is still being sent,
+    // a direct frame that is swapped by the helper has to be sent before it is restored
+    async_flush = false;
+    if (flush_cb == disp_flushDMA || (flush_cb == disp_flushDirect && swap_in_driver)) {
+        async_flush = board.setFlushReadyCallback(disp_flush_ready_cb, disp_drv);
+    }
+
     if (board.hasTouch()) {
         indev_drv = lv_indev_create();
         lv_indev_set_type(indev_drv, LV_INDEV_TYPE_POINTER);
@@ -148,6 +357,45 @@ void beginLvglHelper(LilyGo_Display &board, bool debug)
     lv_tick_set_cb(lv_tick_get_cb);
 
     lv_group_set_default(lv_group_create());
+
+    resetLvglHelperStats();
+    return true;
+}
+
+void beginLvglHelper(LilyGo_Display &board, bool debug)
+{
+    if (!beginLvglHelper(board, LV_HELPER_BUF_PSRAM_FULL, 0, debug)) {
+        log_e("LVGL helper not started");
+    }
+}
+
+void beginLvglHelperDMA(LilyGo_Display &board, bool debug)
+{
+    if (!beginLvglHelper(board, LV_HELPER_BUF_SRAM_STRIPES, 0, debug)) {
+        log_e("LVGL helper not started");
+    }
+}
+
+const char *getLvglHelperBufferingName(LvHelperBuffering_t policy)
+{
+    if (policy > LV_HELPER_BUF_HYBRID) {
+        return "Unknown";
+    }
+    return buffering_name[policy];
+}
+
+void getLvglHelperStats(LvHelperStats_t *stats)
+{
+    if (!stats) {
+        return;
+    }
+    memcpy(stats, &helper_stats, sizeof(LvHelperStats_t));
+}
+
+void resetLvglHelperStats()
+{
+    memset(&helper_stats, 0, sizeof(helper_stats));
+    frame_start_us = render_mark_us = esp_timer_get_time();
 }
 
 void beginLvglInputDevice(struct InputParams prams)
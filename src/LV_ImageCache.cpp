@@ -0,0 +1,270 @@
+/**
+ * @file      LV_ImageCache.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2025  Shenzhen Xin Yuan Electronic Technology Co., Ltd
+ * @date      2025-03-18
+ * @note      lvgl 9 has its own image cache, see LV_CACHE_DEF_SIZE in lv_conf.h.v9
+ */
+#include <Arduino.h>
+#include "LV_ImageCache.h"
+
+#if LVGL_VERSION_MAJOR == 8
+#include <misc/lv_lru.h>
+
+// Longer paths are not cached
+#define IMAGE_CACHE_KEY_MAX         (128)
+// Expected size of a decoded image, sizes the hash table of the LRU
+#define IMAGE_CACHE_AVERAGE_SIZE    (64U * 1024U)
+
+typedef struct __ImageEntry {
+    lv_img_header_t header;
+    uint32_t size;
+    uint16_t refs;                  //Decoder descriptors still drawing from it
+    bool evicted;
+    uint8_t *data;
+} ImageEntry_t;
+
+static lv_img_decoder_t *cache_decoder = NULL;
+static lv_lru_t *cache = NULL;
+static uint32_t cache_budget;
+// Set while the cache asks the other decoders, so it does not answer itself
+static bool bypass = false;
+static LvImageCacheStats_t cache_stats;
+
+static void entry_free(void *v)
+{
+    ImageEntry_t *entry = (ImageEntry_t *)v;
+    cache_stats.evictions++;
+    cache_stats.entries--;
+    // lvgl keeps the last drawn image open, it is freed when closed
+    if (entry->refs) {
+        entry->evicted = true;
+        return;
+    }
+    free(entry);
+}
+
+static size_t make_key(const void *src, uint8_t *key)
+{
+    if (lv_img_src_get_type(src) == LV_IMG_SRC_FILE) {
+        size_t len = strlen((const char *)src);
+        if (len > IMAGE_CACHE_KEY_MAX) {
+            return 0;
+        }
+        memcpy(key, src, len);
+        return len;
+    }
+    // A variable is identified by where its data is and how long it is
+    const lv_img_dsc_t *img = (const lv_img_dsc_t *)src;
+    struct {
+        const void *data;
+        uint32_t size;
+    } var = { img->data, img->data_size };
+    memcpy(key, &var, sizeof(var));
+    return sizeof(var);
+}
+
+// Only formats whose decoded pixels are plain RGB565, with or without alpha
+static bool decoded_format(lv_img_cf_t cf)
+{
+    switch (cf) {
+    case LV_IMG_CF_TRUE_COLOR:
+    case LV_IMG_CF_TRUE_COLOR_ALPHA:
+    case LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED:
+    case LV_IMG_CF_RAW:
+    case LV_IMG_CF_RAW_ALPHA:
+    case LV_IMG_CF_RAW_CHROMA_KEYED:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool cacheable(const void *src)
+{
+    switch (lv_img_src_get_type(src)) {
+    case LV_IMG_SRC_FILE:
+        return true;
+    case LV_IMG_SRC_VARIABLE: {
+        // Plain true color variables are already drawn straight from flash
+        lv_img_cf_t cf = ((const lv_img_dsc_t *)src)->header.cf;
+        return cf == LV_IMG_CF_RAW || cf == LV_IMG_CF_RAW_ALPHA || cf == LV_IMG_CF_RAW_CHROMA_KEYED;
+    }
+    default:
+        return false;
+    }
+}
+
+static ImageEntry_t *lookup(const void *src)
+{
+    uint8_t key[IMAGE_CACHE_KEY_MAX];
+    size_t key_len = make_key(src, key);
+    void *value = NULL;
+    if (key_len) {
+        lv_lru_get(cache, key, key_len, &value);
+    }
+    return (ImageEntry_t *)value;
+}
+
+static lv_res_t cache_info(lv_img_decoder_t *decoder, const void *src, lv_img_header_t *header)
+{
+    if (bypass || !cacheable(src)) {
+        return LV_RES_INV;
+    }
+    ImageEntry_t *entry = lookup(src);
+    if (entry) {
+        *header = entry->header;
+        return LV_RES_OK;
+    }
+    bypass = true;
+    lv_res_t res = lv_img_decoder_get_info(src, header);
+    bypass = false;
+    if (res != LV_RES_OK || !decoded_format((lv_img_cf_t)header->cf)) {
+        return LV_RES_INV;
+    }
+    return LV_RES_OK;
+}
+
+static lv_res_t cache_open(lv_img_decoder_t *decoder, lv_img_decoder_dsc_t *dsc)
+{
+    ImageEntry_t *entry = lookup(dsc->src);
+    if (entry) {
+        cache_stats.hits++;
+        entry->refs++;
+        dsc->header = entry->header;
+        dsc->img_data = entry->data;
+        dsc->user_data = entry;
+        return LV_RES_OK;
+    }
+
+    uint8_t key[IMAGE_CACHE_KEY_MAX];
+    size_t key_len = make_key(dsc->src, key);
+    uint32_t w = dsc->header.w;
+    uint32_t h = dsc->header.h;
+    uint32_t px_size = lv_img_cf_has_alpha(dsc->header.cf) ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+    uint32_t size = w * h * px_size;
+    if (!key_len || !size || size > cache_budget) {
+        // Let the next decoder open it without the cache
+        cache_stats.uncached++;
+        return LV_RES_INV;
+    }
+    cache_stats.misses++;
+
+    lv_img_decoder_dsc_t inner;
+    bypass = true;
+    lv_res_t res = lv_img_decoder_open(&inner, dsc->src, dsc->color, dsc->frame_id);
+    bypass = false;
+    if (res != LV_RES_OK) {
+        return LV_RES_INV;
+    }
+
+    entry = (ImageEntry_t *)ps_malloc(sizeof(ImageEntry_t) + size);
+    if (!entry) {
+        log_e("No PSRAM for a %lu byte decoded image", (unsigned long)size);
+        lv_img_decoder_close(&inner);
+        return LV_RES_INV;
+    }
+    entry->header = dsc->header;
+    entry->size = size;
+    entry->refs = 0;
+    entry->evicted = false;
+    entry->data = (uint8_t *)(entry + 1);
+
+    if (inner.img_data) {
+        memcpy(entry->data, inner.img_data, size);
+    } else {
+        // Line based decoders (SJPG, BMP, files) are read once, row by row
+        uint32_t stride = w * px_size;
+        for (uint32_t y = 0; y < h && res == LV_RES_OK; y++) {
+            res = lv_img_decoder_read_line(&inner, 0, y, w, entry->data + y * stride);
+        }
+    }
+    lv_img_decoder_close(&inner);
+    if (res != LV_RES_OK) {
+        free(entry);
+        return LV_RES_INV;
+    }
+
+    entry->refs = 1;
+    cache_stats.entries++;
+    lv_lru_set(cache, key, key_len, entry, size);
+
+    dsc->img_data = entry->data;
+    dsc->user_data = entry;
+    return LV_RES_OK;
+}
+
+static void cache_close(lv_img_decoder_t *decoder, lv_img_decoder_dsc_t *dsc)
+{
+    ImageEntry_t *entry = (ImageEntry_t *)dsc->user_data;
+    if (!entry) {
+        return;
+    }
+    dsc->user_data = NULL;
+    if (--entry->refs == 0 && entry->evicted) {
+        free(entry);
+    }
+}
+
+bool beginLvglImageCache(uint32_t bytes)
+{
+    if (cache_decoder) {
+        return true;
+    }
+    cache = lv_lru_create(bytes, IMAGE_CACHE_AVERAGE_SIZE, entry_free, lv_mem_free);
+    if (!cache) {
+        log_e("Failed to create the image cache");
+        return false;
+    }
+    // New decoders are asked first, so this one sits in front of PNG, SJPG and BMP
+    cache_decoder = lv_img_decoder_create();
+    if (!cache_decoder) {
+        lv_lru_del(cache);
+        cache = NULL;
+        return false;
+    }
+    lv_img_decoder_set_info_cb(cache_decoder, cache_info);
+    lv_img_decoder_set_open_cb(cache_decoder, cache_open);
+    lv_img_decoder_set_close_cb(cache_decoder, cache_close);
+
+    cache_budget = bytes;
+    memset(&cache_stats, 0, sizeof(cache_stats));
+    return true;
+}
+
+void invalidateLvglImageCache(const void *src)
+{
+    if (!cache) {
+        return;
+    }
+    if (!src) {
+        // Emptied in place, a new LRU could fail to allocate while the decoder is registered
+        size_t free_memory;
+        do {
+            free_memory = cache->free_memory;
+            lv_lru_remove_lru_item(cache);
+        } while (cache->free_memory != free_memory);
+        return;
+    }
+    if (!cacheable(src)) {
+        return;
+    }
+    uint8_t key[IMAGE_CACHE_KEY_MAX];
+    size_t key_len = make_key(src, key);
+    if (key_len) {
+        lv_lru_remove(cache, key, key_len);
+    }
+}
+
+void getLvglImageCacheStats(LvImageCacheStats_t *stats)
+{
+    if (!stats) {
+        return;
+    }
+    *stats = cache_stats;
+    stats->budget = cache_budget;
+    stats->bytes = cache ? cache->total_memory - cache->free_memory : 0;
+}
+
+#endif
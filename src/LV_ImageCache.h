@@ -0,0 +1,41 @@
+/**
+ * @file      LV_ImageCache.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2025  Shenzhen Xin Yuan Electronic Technology Co., Ltd
+ * @date      2025-03-18
+ * @note      Decoded image cache for lvgl 8. File sources and encoded variables
+ *            (PNG, SJPG, BMP) are decoded once into PSRAM, redraws copy the pixels.
+ */
+#pragma once
+
+#include <lvgl.h>
+
+// Default PSRAM budget for the decoded pixels
+#ifndef LV_IMAGE_CACHE_SIZE
+#define LV_IMAGE_CACHE_SIZE         (2U * 1024U * 1024U)
+#endif
+
+typedef struct __LvImageCacheStats {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;             //Entries dropped to make room or invalidated
+    uint32_t uncached;              //Opens too large for the budget, left to the decoders
+    uint32_t entries;
+    uint32_t bytes;                 //Decoded pixels held
+    uint32_t budget;
+} LvImageCacheStats_t;
+
+/**
+ * @brief  Put the cache in front of the image decoders, call after beginLvglHelper
+ * @note   Images are keyed by their path, or by address and size for variables.
+ *         Call invalidateLvglImageCache() after rewriting a file that is still displayed
+ * @param  bytes: PSRAM budget, the least recently drawn images are evicted first
+ * @retval Returns false if the decoder cannot be created
+ */
+bool beginLvglImageCache(uint32_t bytes = LV_IMAGE_CACHE_SIZE);
+
+// Forget one source, or everything when src is NULL
+void invalidateLvglImageCache(const void *src = NULL);
+
+void getLvglImageCacheStats(LvImageCacheStats_t *stats);
@@ -0,0 +1,101 @@
+/**
+ * @file      LV_ProgressBar.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2025  Shenzhen Xin Yuan Electronic Technology Co., Ltd
+ * @date      2025-03-18
+ * @note      lv_bar invalidates the whole object on every change, at display rate that
+ *            redraws the bar and everything behind it each frame.
+ */
+#include <Arduino.h>
+#include "LV_ProgressBar.h"
+
+#if LVGL_VERSION_MAJOR == 8
+
+typedef struct __ProgressBar {
+    lv_coord_t fill;                            //Filled width in pixels
+    lv_color_t color;
+    lv_color_t bg_color;
+} ProgressBar_t;
+
+static void progress_bar_event(lv_event_t *e)
+{
+    lv_obj_t *obj = lv_event_get_target(e);
+    ProgressBar_t *bar = (ProgressBar_t *)lv_obj_get_user_data(obj);
+    if (!bar) {
+        return;
+    }
+
+    if (lv_event_get_code(e) == LV_EVENT_DELETE) {
+        free(bar);
+        lv_obj_set_user_data(obj, NULL);
+        return;
+    }
+
+    // LV_EVENT_DRAW_MAIN, both parts are clipped to the invalidated columns
+    lv_draw_ctx_t *draw_ctx = lv_event_get_draw_ctx(e);
+    lv_draw_rect_dsc_t dsc;
+    lv_draw_rect_dsc_init(&dsc);
+    dsc.radius = LV_RADIUS_CIRCLE;
+    dsc.bg_color = bar->bg_color;
+    lv_draw_rect(draw_ctx, &dsc, &obj->coords);
+    if (bar->fill > 0) {
+        lv_area_t indic = obj->coords;
+        indic.x2 = indic.x1 + bar->fill - 1;
+        dsc.bg_color = bar->color;
+        lv_draw_rect(draw_ctx, &dsc, &indic);
+    }
+}
+
+lv_obj_t *createLvglProgressBar(lv_obj_t *parent, lv_coord_t w, lv_coord_t h,
+                                lv_color_t color, lv_color_t bg_color)
+{
+    ProgressBar_t *bar = (ProgressBar_t *)calloc(1, sizeof(ProgressBar_t));
+    if (!bar) {
+        return NULL;
+    }
+    bar->color = color;
+    bar->bg_color = bg_color;
+
+    lv_obj_t *obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(obj);
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_size(obj, w, h);
+    lv_obj_set_user_data(obj, bar);
+    lv_obj_add_event_cb(obj, progress_bar_event, LV_EVENT_DRAW_MAIN, NULL);
+    lv_obj_add_event_cb(obj, progress_bar_event, LV_EVENT_DELETE, NULL);
+    return obj;
+}
+
+void setLvglProgressBarValue(lv_obj_t *obj, uint32_t value, uint32_t max)
+{
+    ProgressBar_t *bar = obj ? (ProgressBar_t *)lv_obj_get_user_data(obj) : NULL;
+    if (!bar) {
+        return;
+    }
+    lv_coord_t w = lv_obj_get_width(obj);
+    lv_coord_t fill = 0;
+    if (max > 0) {
+        fill = (lv_coord_t)((uint64_t)(value < max ? value : max) * w / max);
+    }
+    if (fill == bar->fill) {
+        return;
+    }
+
+    // The round end reaches back half the height from the end of the fill,
+    // while the fill is shorter than the height its start is rounded less as well
+    lv_coord_t r = lv_obj_get_height(obj) / 2;
+    lv_coord_t from = LV_MIN(fill, bar->fill);
+    lv_area_t area = obj->coords;
+    area.x1 = obj->coords.x1 + (from > 2 * r ? from - r : 0);
+    area.x2 = obj->coords.x1 + LV_MAX(fill, bar->fill) + r;
+    bar->fill = fill;
+
+    // lv_obj_invalidate_area() grows every area by 5 pixels, for any object,
+    // for a bar a few pixels high that is most of what gets redrawn
+    if (lv_obj_is_visible(obj) && _lv_area_intersect(&area, &area, &obj->coords)) {
+        _lv_inv_area(lv_obj_get_disp(obj), &area);
+    }
+}
+
+#endif
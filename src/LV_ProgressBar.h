@@ -0,0 +1,31 @@
+/**
+ * @file      LV_ProgressBar.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2025  Shenzhen Xin Yuan Electronic Technology Co., Ltd
+ * @date      2025-03-18
+ * @note      Thin progress bar for lvgl 8 that can be updated every frame. A new value
+ *            only invalidates the columns the end of the bar moved across.
+ */
+#pragma once
+
+#include <lvgl.h>
+
+/**
+ * @brief  Create a progress bar with round ends
+ * @note   The object's user data is used by the bar
+ * @param  parent: Parent object
+ * @param  w: Width, the value moves in steps of one column
+ * @param  h: Height, the ends are rounded with h / 2
+ * @param  color: Color of the filled part
+ * @param  bg_color: Color of the rest
+ * @retval The bar, NULL if it cannot be allocated
+ */
+lv_obj_t *createLvglProgressBar(lv_obj_t *parent, lv_coord_t w, lv_coord_t h,
+                                lv_color_t color, lv_color_t bg_color);
+
+/**
+ * @brief  Fill value / max of the bar, nothing is invalidated while the filled width stays the same
+ * @note   Call from the lvgl task. An empty max leaves the bar empty
+ */
+void setLvglProgressBarValue(lv_obj_t *bar, uint32_t value, uint32_t max);
@@ -0,0 +1,341 @@
+/**
+ * @file      LV_Runtime.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2025  Shenzhen Xin Yuan Electronic Technology Co., Ltd
+ * @date      2025-03-18
+ * @note      Supports lvgl 8 and lvgl 9
+ */
+#include <Arduino.h>
+#include <stdarg.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include "LV_Runtime.h"
+
+#if (LV_RUNTIME_QUEUE_SIZE & (LV_RUNTIME_QUEUE_SIZE - 1)) != 0
+#error "LV_RUNTIME_QUEUE_SIZE must be a power of two"
+#endif
+
+#define LV_RUNTIME_STACK_SIZE       (8192)
+
+/*
+* Bounded multi producer, single consumer ring.
+* A producer claims a position with a compare and swap on tail, fills the slot
+* and then publishes it by setting its sequence to pos + 1. The render task
+* only reads slots whose sequence says they are published, and hands them
+* back to the producers one lap later by setting it to pos + LV_RUNTIME_QUEUE_SIZE.
+* */
+typedef struct __LvRuntimeSlot {
+    uint32_t seq;
+    LvRuntimeUpdate_t update;
+} LvRuntimeSlot_t;
+
+static LvRuntimeSlot_t queue[LV_RUNTIME_QUEUE_SIZE];
+static uint32_t queue_tail;
+static uint32_t queue_head;
+static uint32_t queue_dropped;
+
+static TaskHandle_t runtime_task = NULL;
+static SemaphoreHandle_t runtime_lock = NULL;
+static uint32_t runtime_period;
+static LvRuntimeStats_t runtime_stats;
+
+static void apply_update(const LvRuntimeUpdate_t *u)
+{
+    switch (u->op) {
+    case LV_RUNTIME_LABEL_TEXT:
+        lv_label_set_text(u->obj, u->text);
+        break;
+    case LV_RUNTIME_STATE:
+        if (u->enable) {
+            lv_obj_add_state(u->obj, (lv_state_t)u->value);
+        } else {
+#if LVGL_VERSION_MAJOR == 9
+            lv_obj_remove_state(u->obj, (lv_state_t)u->value);
+#else
+            lv_obj_clear_state(u->obj, (lv_state_t)u->value);
+#endif
+        }
+        break;
+    case LV_RUNTIME_FLAG:
+        if (u->enable) {
+            lv_obj_add_flag(u->obj, (lv_obj_flag_t)u->value);
+        } else {
+#if LVGL_VERSION_MAJOR == 9
+            lv_obj_remove_flag(u->obj, (lv_obj_flag_t)u->value);
+#else
+            lv_obj_clear_flag(u->obj, (lv_obj_flag_t)u->value);
+#endif
+        }
+        break;
+    case LV_RUNTIME_IMAGE_SRC:
+#if LVGL_VERSION_MAJOR == 9
+        lv_image_set_src(u->obj, u->src);
+#else
+        lv_img_set_src(u->obj, u->src);
+#endif
+        break;
+    case LV_RUNTIME_TEXT_COLOR:
+        lv_obj_set_style_text_color(u->obj, lv_color_hex(u->value), 0);
+        break;
+    case LV_RUNTIME_CALL:
+        u->call((void *)u->src);
+        break;
+    case LV_RUNTIME_TEXT_CALL:
+        u->text_call(u->obj, u->text);
+        break;
+    default:
+        break;
+    }
+}
+
+static LvRuntimeUpdate_t *queue_claim(uint32_t *pos)
+{
+    uint32_t p = __atomic_load_n(&queue_tail, __ATOMIC_RELAXED);
+    for (;;) {
+        LvRuntimeSlot_t *slot = &queue[p & (LV_RUNTIME_QUEUE_SIZE - 1)];
+        int32_t diff = (int32_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - p);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&queue_tail, &p, p + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                *pos = p;
+                return &slot->update;
+            }
+        } else if (diff < 0) {
+            // The render task has not consumed this slot yet, the queue is full
+            __atomic_fetch_add(&queue_dropped, 1, __ATOMIC_RELAXED);
+            return NULL;
+        } else {
+            p = __atomic_load_n(&queue_tail, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void queue_publish(uint32_t pos)
+{
+    __atomic_store_n(&queue[pos & (LV_RUNTIME_QUEUE_SIZE - 1)].seq, pos + 1, __ATOMIC_RELEASE);
+}
+
+static uint32_t queue_drain()
+{
+    uint32_t count = 0;
+    for (;;) {
+        LvRuntimeSlot_t *slot = &queue[queue_head & (LV_RUNTIME_QUEUE_SIZE - 1)];
+        if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != queue_head + 1) {
+            break;
+        }
+        apply_update(&slot->update);
+        __atomic_store_n(&slot->seq, queue_head + LV_RUNTIME_QUEUE_SIZE, __ATOMIC_RELEASE);
+        queue_head++;
+        count++;
+    }
+    return count;
+}
+
+static void lv_runtime_task(void *args)
+{
+    for (;;) {
+        xSemaphoreTakeRecursive(runtime_lock, portMAX_DELAY);
+        uint32_t batch = queue_drain();
+        uint32_t next = lv_timer_handler();
+        xSemaphoreGiveRecursive(runtime_lock);
+
+        runtime_stats.frameCount++;
+        runtime_stats.applied += batch;
+        if (batch > runtime_stats.maxBatch) {
+            runtime_stats.maxBatch = batch;
+        }
+
+        // Always sleep at least one tick so lower priority tasks on this core can run
+        uint32_t wait = next < runtime_period ? next : runtime_period;
+        TickType_t ticks = pdMS_TO_TICKS(wait);
+        vTaskDelay(ticks ? ticks : 1);
+    }
+}
+
+bool beginLvglRuntime(BaseType_t core, UBaseType_t priority, uint32_t period_ms)
+{
+    if (runtime_task) {
+        return true;
+    }
+    for (uint32_t i = 0; i < LV_RUNTIME_QUEUE_SIZE; ++i) {
+        queue[i].seq = i;
+    }
+    queue_head = queue_tail = 0;
+    queue_dropped = 0;
+    memset(&runtime_stats, 0, sizeof(runtime_stats));
+    runtime_period = period_ms ? period_ms : 1;
+
+    if (!runtime_lock) {
+        runtime_lock = xSemaphoreCreateRecursiveMutex();
+        if (!runtime_lock) {
+            log_e("Failed to create lvgl runtime lock");
+            return false;
+        }
+    }
+    if (xTaskCreatePinnedToCore(lv_runtime_task, "lvgl", LV_RUNTIME_STACK_SIZE, NULL,
+                                priority, &runtime_task, core) != pdPASS) {
+        log_e("Failed to create lvgl runtime task");
+        runtime_task = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool isLvglRuntimeRunning()
+{
+    return runtime_task != NULL;
+}
+
+bool lvglRuntimeLock(uint32_t timeout_ms)
+{
+    if (!runtime_lock) {
+        return true;
+    }
+    TickType_t ticks = timeout_ms == portMAX_DELAY ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    return xSemaphoreTakeRecursive(runtime_lock, ticks) == pdTRUE;
+}
+
+void lvglRuntimeUnlock()
+{
+    if (runtime_lock) {
+        xSemaphoreGiveRecursive(runtime_lock);
+    }
+}
+
+/*
+* Before the runtime is started lvgl is only used by the caller's task,
+* so the update is applied right away.
+* */
+static bool post_update(const LvRuntimeUpdate_t *u)
+{
+    if (!runtime_task) {
+        apply_update(u);
+        return true;
+    }
+    uint32_t pos;
+    LvRuntimeUpdate_t *dst = queue_claim(&pos);
+    if (!dst) {
+        return false;
+    }
+    memcpy(dst, u, offsetof(LvRuntimeUpdate_t, text));
+    if (u->op == LV_RUNTIME_LABEL_TEXT || u->op == LV_RUNTIME_TEXT_CALL) {
+        strcpy(dst->text, u->text);
+    }
+    queue_publish(pos);
+    return true;
+}
+
+bool postLvglLabelText(lv_obj_t *label, const char *text)
+{
+    if (!label) {
+        return false;
+    }
+    LvRuntimeUpdate_t u;
+    u.op = LV_RUNTIME_LABEL_TEXT;
+    u.obj = label;
+    strncpy(u.text, text ? text : "", LV_RUNTIME_TEXT_LEN - 1);
+    u.text[LV_RUNTIME_TEXT_LEN - 1] = '\0';
+    return post_update(&u);
+}
+
+bool postLvglLabelTextFmt(lv_obj_t *label, const char *fmt, ...)
+{
+    if (!label) {
+        return false;
+    }
+    LvRuntimeUpdate_t u;
+    u.op = LV_RUNTIME_LABEL_TEXT;
+    u.obj = label;
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(u.text, LV_RUNTIME_TEXT_LEN, fmt, args);
+    va_end(args);
+    return post_update(&u);
+}
+
+bool postLvglState(lv_obj_t *obj, lv_state_t state, bool enable)
+{
+    if (!obj) {
+        return false;
+    }
+    LvRuntimeUpdate_t u;
+    u.op = LV_RUNTIME_STATE;
+    u.obj = obj;
+    u.value = state;
+    u.enable = enable;
+    return post_update(&u);
+}
+
+bool postLvglFlag(lv_obj_t *obj, lv_obj_flag_t flag, bool enable)
+{
+    if (!obj) {
+        return false;
+    }
+    LvRuntimeUpdate_t u;
+    u.op = LV_RUNTIME_FLAG;
+    u.obj = obj;
+    u.value = flag;
+    u.enable = enable;
+    return post_update(&u);
+}
+
+bool postLvglImageSrc(lv_obj_t *img, const void *src)
+{
+    if (!img) {
+        return false;
+    }
+    LvRuntimeUpdate_t u;
+    u.op = LV_RUNTIME_IMAGE_SRC;
+    u.obj = img;
+    u.src = src;
+    return post_update(&u);
+}
+
+bool postLvglTextColor(lv_obj_t *obj, uint32_t color)
+{
+    if (!obj) {
+        return false;
+    }
+    LvRuntimeUpdate_t u;
+    u.op = LV_RUNTIME_TEXT_COLOR;
+    u.obj = obj;
+    u.value = color;
+    return post_update(&u);
+}
+
+bool postLvglCall(void (*fn)(void *arg), void *arg)
+{
+    if (!fn) {
+        return false;
+    }
+    LvRuntimeUpdate_t u;
+    u.op = LV_RUNTIME_CALL;
+    u.obj = NULL;
+    u.call = fn;
+    u.src = arg;
+    return post_update(&u);
+}
+
+bool postLvglTextCall(lv_obj_t *obj, void (*fn)(lv_obj_t *obj, const char *text), const char *text)
+{
+    if (!obj || !fn) {
+        return false;
+    }
+    LvRuntimeUpdate_t u;
+    u.op = LV_RUNTIME_TEXT_CALL;
+    u.obj = obj;
+    u.text_call = fn;
+    strncpy(u.text, text ? text : "", LV_RUNTIME_TEXT_LEN - 1);
+    u.text[LV_RUNTIME_TEXT_LEN - 1] = '\0';
+    return post_update(&u);
+}
+
+void getLvglRuntimeStats(LvRuntimeStats_t *stats)
+{
+    if (!stats) {
+        return;
+    }
+    *stats = runtime_stats;
+    stats->dropped = __atomic_load_n(&queue_dropped, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,89 @@
+/**
+ * @file      LV_Runtime.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2025  Shenzhen Xin Yuan Electronic Technology Co., Ltd
+ * @date      2025-03-18
+ * @note      Runs lv_timer_handler on its own task. Other tasks must not call lvgl
+ *            directly once the runtime is started, they post updates instead.
+ */
+#pragma once
+
+#include <lvgl.h>
+#include <freertos/FreeRTOS.h>
+
+// Number of updates that can wait for the next frame, must be a power of two
+#ifndef LV_RUNTIME_QUEUE_SIZE
+#define LV_RUNTIME_QUEUE_SIZE       (32)
+#endif
+
+// Label text is copied into the queue, longer text is truncated
+#ifndef LV_RUNTIME_TEXT_LEN
+#define LV_RUNTIME_TEXT_LEN         (128)
+#endif
+
+typedef enum {
+    LV_RUNTIME_LABEL_TEXT,
+    LV_RUNTIME_STATE,
+    LV_RUNTIME_FLAG,
+    LV_RUNTIME_IMAGE_SRC,
+    LV_RUNTIME_TEXT_COLOR,
+    LV_RUNTIME_CALL,
+    LV_RUNTIME_TEXT_CALL,
+} LvRuntimeOp_t;
+
+typedef struct __LvRuntimeUpdate {
+    LvRuntimeOp_t op;
+    lv_obj_t *obj;
+    uint32_t value;                 //State, flag or color
+    bool enable;                    //Add or clear the state or flag
+    const void *src;                //Image source or call argument
+    void (*call)(void *arg);
+    void (*text_call)(lv_obj_t *obj, const char *text);
+    char text[LV_RUNTIME_TEXT_LEN];
+} LvRuntimeUpdate_t;
+
+typedef struct __LvRuntimeStats {
+    uint32_t frameCount;
+    uint32_t applied;               //Updates applied by the render task
+    uint32_t dropped;               //Updates lost because the queue was full
+    uint32_t maxBatch;              //Most updates applied before a single frame
+} LvRuntimeStats_t;
+
+/**
+ * @brief  Start the render task, call after beginLvglHelper and the initial UI setup
+ * @param  core: CPU the task is pinned to
+ * @param  priority: Task priority, above the Arduino loop task by default
+ * @param  period_ms: Longest sleep between two frames
+ * @retval Returns false if the task or its lock cannot be created
+ */
+bool beginLvglRuntime(BaseType_t core = 1, UBaseType_t priority = 2, uint32_t period_ms = 5);
+bool isLvglRuntimeRunning();
+
+/**
+ * @brief  Take the lvgl lock for code that has to build objects from another task
+ * @note   Keep it short, the render task waits for it. Not needed from lvgl callbacks
+ * @param  timeout_ms: How long to wait for the render task to finish its frame
+ * @retval Returns false on timeout
+ */
+bool lvglRuntimeLock(uint32_t timeout_ms = portMAX_DELAY);
+void lvglRuntimeUnlock();
+
+/*
+* Post functions can be called from any task, the updates are applied in order
+* before the next frame. They return false if the queue is full.
+* Objects must stay alive until their pending updates are applied.
+* */
+bool postLvglLabelText(lv_obj_t *label, const char *text);
+bool postLvglLabelTextFmt(lv_obj_t *label, const char *fmt, ...);
+bool postLvglState(lv_obj_t *obj, lv_state_t state, bool enable);
+bool postLvglFlag(lv_obj_t *obj, lv_obj_flag_t flag, bool enable);
+// The image source is not copied, it must remain valid
+bool postLvglImageSrc(lv_obj_t *img, const void *src);
+bool postLvglTextColor(lv_obj_t *obj, uint32_t color);
+// Run fn(arg) on the render task, for changes not covered above
+bool postLvglCall(void (*fn)(void *arg), void *arg);
+// Run fn(obj, text) on the render task with a copy of text, for text setters of other widgets
+bool postLvglTextCall(lv_obj_t *obj, void (*fn)(lv_obj_t *obj, const char *text), const char *text);
+
+void getLvglRuntimeStats(LvRuntimeStats_t *stats);
@@ -0,0 +1,295 @@
+/**
+ * @file      LV_ShadowCache.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2025  Shenzhen Xin Yuan Electronic Technology Co., Ltd
+ * @date      2025-03-18
+ * @note      The mask is captured from lvgl's own shadow renderer, so cached shadows
+ *            look the same as uncached ones. lvgl 9 caches shadows itself.
+ */
+#include <Arduino.h>
+#include "LV_ShadowCache.h"
+
+#if LVGL_VERSION_MAJOR == 8 && LV_DRAW_COMPLEX
+#include <misc/lv_lru.h>
+#include <draw/sw/lv_draw_sw.h>
+
+// Expected size of a shadow mask, sizes the hash table of the LRU
+#define SHADOW_CACHE_AVERAGE_SIZE   (16U * 1024U)
+
+// Everything that changes the shape of the mask, the position and color do not
+typedef struct __ShadowKey {
+    lv_coord_t w;
+    lv_coord_t h;
+    lv_coord_t radius;
+    lv_coord_t width;
+    lv_coord_t spread;
+    lv_coord_t ofs_x;
+    lv_coord_t ofs_y;
+} ShadowKey_t;
+
+static lv_draw_ctx_t *cache_ctx = NULL;
+static void (*draw_rect_cb)(lv_draw_ctx_t *draw_ctx, const lv_draw_rect_dsc_t *dsc, const lv_area_t *coords) = NULL;
+static lv_lru_t *cache = NULL;
+static uint32_t cache_budget;
+static LvShadowCacheStats_t cache_stats;
+// Mask being filled by capture_blend
+static lv_opa_t *capture_buf = NULL;
+
+static void entry_free(void *v)
+{
+    cache_stats.evictions++;
+    cache_stats.entries--;
+    free(v);
+}
+
+// Same checks as lvgl's draw_shadow
+static bool shadow_visible(const lv_draw_rect_dsc_t *dsc)
+{
+    if (dsc->shadow_width == 0 || dsc->shadow_opa <= LV_OPA_MIN) {
+        return false;
+    }
+    return !(dsc->shadow_width == 1 && dsc->shadow_spread <= 0 &&
+             dsc->shadow_ofs_x == 0 && dsc->shadow_ofs_y == 0);
+}
+
+static void shadow_area_get(const lv_draw_rect_dsc_t *dsc, const lv_area_t *coords, lv_area_t *area)
+{
+    lv_coord_t grow = dsc->shadow_spread + dsc->shadow_width / 2 + 1;
+    area->x1 = coords->x1 + dsc->shadow_ofs_x - grow;
+    area->x2 = coords->x2 + dsc->shadow_ofs_x + grow;
+    area->y1 = coords->y1 + dsc->shadow_ofs_y - grow;
+    area->y2 = coords->y2 + dsc->shadow_ofs_y + grow;
+}
+
+/*
+* Stands in for the blend function while lvgl draws a shadow into a mask.
+* The corners, sides and center of a shadow do not overlap, every pixel is
+* written once with the opacity lvgl would have blended the color with.
+* */
+static void capture_blend(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc)
+{
+    lv_area_t area;
+    if (!_lv_area_intersect(&area, dsc->blend_area, draw_ctx->clip_area)) {
+        return;
+    }
+    const lv_opa_t *mask = NULL;
+    lv_coord_t mask_stride = 0;
+    if (dsc->mask_buf) {
+        if (dsc->mask_res == LV_DRAW_MASK_RES_TRANSP) {
+            return;
+        }
+        if (dsc->mask_res != LV_DRAW_MASK_RES_FULL_COVER) {
+            mask_stride = lv_area_get_width(dsc->mask_area);
+            mask = dsc->mask_buf + mask_stride * (area.y1 - dsc->mask_area->y1) + (area.x1 - dsc->mask_area->x1);
+        }
+    }
+
+    lv_opa_t opa = dsc->opa >= LV_OPA_MAX ? LV_OPA_COVER : dsc->opa;
+    lv_coord_t stride = lv_area_get_width(draw_ctx->buf_area);
+    lv_opa_t *dst = capture_buf + stride * (area.y1 - draw_ctx->buf_area->y1) + (area.x1 - draw_ctx->buf_area->x1);
+    lv_coord_t w = lv_area_get_width(&area);
+    for (lv_coord_t y = area.y1; y <= area.y2; y++) {
+        for (lv_coord_t x = 0; x < w; x++) {
+            if (!mask) {
+                dst[x] = opa;
+            } else if (opa == LV_OPA_COVER || mask[x] == LV_OPA_COVER) {
+                dst[x] = opa == LV_OPA_COVER ? mask[x] : opa;
+            } else {
+                dst[x] = ((uint32_t)mask[x] * opa) >> 8;
+            }
+        }
+        dst += stride;
+        if (mask) {
+            mask += mask_stride;
+        }
+    }
+}
+
+static lv_opa_t *capture_shadow(const lv_draw_rect_dsc_t *dsc, const lv_area_t *coords,
+                                const lv_area_t *shadow_area, uint32_t size)
+{
+    lv_opa_t *mask = (lv_opa_t *)ps_malloc(size);
+    if (!mask) {
+        log_e("No PSRAM for a %lu byte shadow", (unsigned long)size);
+        return NULL;
+    }
+    lv_memset_00(mask, size);
+
+    // Only the shadow, opaque, and always cut out under the background.
+    // lvgl skips that part too or an opaque background covers it.
+    lv_draw_rect_dsc_t sh_dsc;
+    lv_draw_rect_dsc_init(&sh_dsc);
+    sh_dsc.radius = dsc->radius;
+    sh_dsc.bg_opa = LV_OPA_TRANSP;
+    sh_dsc.border_opa = LV_OPA_TRANSP;
+    sh_dsc.outline_opa = LV_OPA_TRANSP;
+    sh_dsc.shadow_width = dsc->shadow_width;
+    sh_dsc.shadow_spread = dsc->shadow_spread;
+    sh_dsc.shadow_ofs_x = dsc->shadow_ofs_x;
+    sh_dsc.shadow_ofs_y = dsc->shadow_ofs_y;
+    sh_dsc.shadow_opa = LV_OPA_COVER;
+
+    lv_area_t buf_area = *shadow_area;
+    lv_draw_sw_ctx_t ctx;
+    lv_memset_00(&ctx, sizeof(ctx));
+    ctx.base_draw.buf_area = &buf_area;
+    ctx.base_draw.clip_area = &buf_area;
+    ctx.blend = capture_blend;
+
+    capture_buf = mask;
+    lv_draw_sw_rect(&ctx.base_draw, &sh_dsc, coords);
+    capture_buf = NULL;
+    return mask;
+}
+
+static lv_opa_t *lookup(const lv_draw_rect_dsc_t *dsc, const lv_area_t *coords, const lv_area_t *shadow_area)
+{
+    ShadowKey_t key;
+    lv_memset_00(&key, sizeof(key));
+    key.w = lv_area_get_width(coords);
+    key.h = lv_area_get_height(coords);
+    key.radius = dsc->radius;
+    key.width = dsc->shadow_width;
+    key.spread = dsc->shadow_spread;
+    key.ofs_x = dsc->shadow_ofs_x;
+    key.ofs_y = dsc->shadow_ofs_y;
+
+    void *value = NULL;
+    lv_lru_get(cache, &key, sizeof(key), &value);
+    if (value) {
+        cache_stats.hits++;
+        return (lv_opa_t *)value;
+    }
+
+    uint32_t size = lv_area_get_size(shadow_area);
+    if (size > cache_budget) {
+        return NULL;
+    }
+    lv_opa_t *mask = capture_shadow(dsc, coords, shadow_area, size);
+    if (!mask) {
+        return NULL;
+    }
+    cache_stats.misses++;
+    cache_stats.entries++;
+    lv_lru_set(cache, &key, sizeof(key), mask, size);
+    return mask;
+}
+
+static void blend_area(lv_draw_ctx_t *draw_ctx, lv_draw_sw_blend_dsc_t *blend_dsc,
+                       lv_coord_t x1, lv_coord_t y1, lv_coord_t x2, lv_coord_t y2)
+{
+    if (x1 > x2 || y1 > y2) {
+        return;
+    }
+    lv_area_t area;
+    area.x1 = x1;
+    area.y1 = y1;
+    area.x2 = x2;
+    area.y2 = y2;
+    blend_dsc->blend_area = &area;
+    lv_draw_sw_blend(draw_ctx, blend_dsc);
+}
+
+static void blend_shadow(lv_draw_ctx_t *draw_ctx, const lv_draw_rect_dsc_t *dsc, const lv_area_t *coords,
+                         const lv_area_t *shadow_area, lv_opa_t *mask)
+{
+    lv_draw_sw_blend_dsc_t blend_dsc;
+    lv_memset_00(&blend_dsc, sizeof(blend_dsc));
+    blend_dsc.mask_buf = mask;
+    blend_dsc.mask_area = shadow_area;
+    blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
+    blend_dsc.color = dsc->shadow_color;
+    blend_dsc.opa = dsc->shadow_opa;
+    blend_dsc.blend_mode = dsc->blend_mode;
+
+    // The mask is empty under the straight part of the background, skip it
+    lv_area_t bg_area = *coords;
+    lv_area_increase(&bg_area, -1, -1);
+    lv_coord_t r_bg = dsc->radius;
+    lv_coord_t short_side = LV_MIN(lv_area_get_width(&bg_area), lv_area_get_height(&bg_area));
+    if (r_bg > short_side >> 1) {
+        r_bg = short_side >> 1;
+    }
+    lv_area_t hole;
+    hole.x1 = bg_area.x1 + 1;
+    hole.x2 = bg_area.x2 - 1;
+    hole.y1 = bg_area.y1 + r_bg + 1;
+    hole.y2 = bg_area.y2 - r_bg - 1;
+
+    lv_area_t inner;
+    if (!_lv_area_intersect(&inner, &hole, shadow_area)) {
+        blend_area(draw_ctx, &blend_dsc, shadow_area->x1, shadow_area->y1, shadow_area->x2, shadow_area->y2);
+        return;
+    }
+    blend_area(draw_ctx, &blend_dsc, shadow_area->x1, shadow_area->y1, shadow_area->x2, inner.y1 - 1);
+    blend_area(draw_ctx, &blend_dsc, shadow_area->x1, inner.y1, inner.x1 - 1, inner.y2);
+    blend_area(draw_ctx, &blend_dsc, inner.x2 + 1, inner.y1, shadow_area->x2, inner.y2);
+    blend_area(draw_ctx, &blend_dsc, shadow_area->x1, inner.y2 + 1, shadow_area->x2, shadow_area->y2);
+}
+
+static void cached_draw_rect(lv_draw_ctx_t *draw_ctx, const lv_draw_rect_dsc_t *dsc, const lv_area_t *coords)
+{
+    if (!shadow_visible(dsc)) {
+        draw_rect_cb(draw_ctx, dsc, coords);
+        return;
+    }
+    lv_area_t shadow_area;
+    shadow_area_get(dsc, coords, &shadow_area);
+    if (!_lv_area_is_on(&shadow_area, draw_ctx->clip_area)) {
+        draw_rect_cb(draw_ctx, dsc, coords);
+        return;
+    }
+
+    // Masks of the parents (rounded clipping, etc.) depend on the position
+    lv_opa_t *mask = NULL;
+    if (!lv_draw_mask_is_any(&shadow_area)) {
+        mask = lookup(dsc, coords, &shadow_area);
+    }
+    if (!mask) {
+        cache_stats.uncached++;
+        draw_rect_cb(draw_ctx, dsc, coords);
+        return;
+    }
+
+    blend_shadow(draw_ctx, dsc, coords, &shadow_area, mask);
+    lv_draw_rect_dsc_t rest = *dsc;
+    rest.shadow_opa = LV_OPA_TRANSP;
+    draw_rect_cb(draw_ctx, &rest, coords);
+}
+
+bool beginLvglShadowCache(uint32_t bytes)
+{
+    if (cache) {
+        return true;
+    }
+    lv_disp_t *disp = lv_disp_get_default();
+    if (!disp || !disp->driver->draw_ctx) {
+        log_e("No lvgl display, call beginLvglHelper first");
+        return false;
+    }
+    cache = lv_lru_create(bytes, SHADOW_CACHE_AVERAGE_SIZE, entry_free, lv_mem_free);
+    if (!cache) {
+        log_e("Failed to create the shadow cache");
+        return false;
+    }
+    cache_budget = bytes;
+    memset(&cache_stats, 0, sizeof(cache_stats));
+
+    cache_ctx = disp->driver->draw_ctx;
+    draw_rect_cb = cache_ctx->draw_rect;
+    cache_ctx->draw_rect = cached_draw_rect;
+    return true;
+}
+
+void getLvglShadowCacheStats(LvShadowCacheStats_t *stats)
+{
+    if (!stats) {
+        return;
+    }
+    *stats = cache_stats;
+    stats->budget = cache_budget;
+    stats->bytes = cache ? cache->total_memory - cache->free_memory : 0;
+}
+
+#endif
@@ -0,0 +1,39 @@
+/**
+ * @file      LV_ShadowCache.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2025  Shenzhen Xin Yuan Electronic Technology Co., Ltd
+ * @date      2025-03-18
+ * @note      Shadow cache for lvgl 8. The blurred shadow of a rectangle is computed
+ *            once into an opacity mask in PSRAM, redraws only blend it with the color.
+ *            Gradient maps are cached by lvgl itself, see LV_GRAD_CACHE_DEF_SIZE in lv_conf.h
+ */
+#pragma once
+
+#include <lvgl.h>
+
+// Default PSRAM budget for the shadow masks
+#ifndef LV_SHADOW_CACHE_BUDGET
+#define LV_SHADOW_CACHE_BUDGET      (256U * 1024U)
+#endif
+
+typedef struct __LvShadowCacheStats {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t uncached;              //Shadows clipped by a parent mask or too large, drawn by lvgl
+    uint32_t entries;
+    uint32_t bytes;                 //Mask bytes held
+    uint32_t budget;
+} LvShadowCacheStats_t;
+
+/**
+ * @brief  Take over the shadow drawing of the default display, call after beginLvglHelper
+ * @note   A shadow is keyed by the rectangle size, radius, width, spread and offset,
+ *         the color and opacity are applied when blending so they share one entry
+ * @param  bytes: PSRAM budget, the least recently drawn shadows are evicted first
+ * @retval Returns false if there is no display or the cache cannot be created
+ */
+bool beginLvglShadowCache(uint32_t bytes = LV_SHADOW_CACHE_BUDGET);
+
+void getLvglShadowCacheStats(LvShadowCacheStats_t *stats);
@@ -0,0 +1,164 @@
+/**
+ * @file      LV_TieredMem.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2025  Shenzhen Xin Yuan Electronic Technology Co., Ltd
+ * @date      2025-03-18
+ * @note      The vendored lv_tlsf is compiled out once LV_MEM_CUSTOM is set, the
+ *            pool is managed by the ESP-IDF multi_heap instead (TLSF since IDF 5).
+ *            lvgl is single threaded, so no lock is taken here.
+ */
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <multi_heap.h>
+#include <lvgl.h>
+#include "LV_TieredMem.h"
+
+#if LVGL_VERSION_MAJOR == 8
+
+static uint8_t *pool_mem = NULL;
+static multi_heap_handle_t pool = NULL;
+static bool pool_failed = false;
+static uint32_t psram_used;
+static uint32_t psram_high_water;
+static uint32_t psram_blocks;
+static uint32_t fallbacks;
+
+static bool pool_init()
+{
+    if (pool || pool_failed) {
+        return pool != NULL;
+    }
+    pool_mem = (uint8_t *)heap_caps_malloc(LV_TIERED_SRAM_POOL_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (pool_mem) {
+        pool = multi_heap_register(pool_mem, LV_TIERED_SRAM_POOL_SIZE);
+    }
+    if (!pool) {
+        // Everything goes to PSRAM, as without this allocator
+        log_e("Failed to create the %u byte lvgl SRAM pool", LV_TIERED_SRAM_POOL_SIZE);
+        heap_caps_free(pool_mem);
+        pool_mem = NULL;
+        pool_failed = true;
+    }
+    return pool != NULL;
+}
+
+static inline bool in_pool(const void *ptr)
+{
+    return pool_mem && (const uint8_t *)ptr >= pool_mem && (const uint8_t *)ptr < pool_mem + LV_TIERED_SRAM_POOL_SIZE;
+}
+
+static void *psram_alloc(size_t size)
+{
+    void *ptr = ps_malloc(size);
+    if (ptr) {
+        psram_used += heap_caps_get_allocated_size(ptr);
+        psram_blocks++;
+        if (psram_used > psram_high_water) {
+            psram_high_water = psram_used;
+        }
+    }
+    return ptr;
+}
+
+static void psram_free(void *ptr)
+{
+    psram_used -= heap_caps_get_allocated_size(ptr);
+    psram_blocks--;
+    free(ptr);
+}
+
+void *lv_tiered_malloc(size_t size)
+{
+    if (size <= LV_TIERED_SRAM_MAX_ALLOC && pool_init()) {
+        void *ptr = multi_heap_malloc(pool, size);
+        if (ptr) {
+            return ptr;
+        }
+        fallbacks++;
+    }
+    return psram_alloc(size);
+}
+
+void lv_tiered_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    if (in_pool(ptr)) {
+        multi_heap_free(pool, ptr);
+    } else {
+        psram_free(ptr);
+    }
+}
+
+void *lv_tiered_realloc(void *ptr, size_t size)
+{
+    if (!ptr) {
+        return lv_tiered_malloc(size);
+    }
+    if (!size) {
+        lv_tiered_free(ptr);
+        return NULL;
+    }
+
+    size_t old_size;
+    if (in_pool(ptr)) {
+        if (size <= LV_TIERED_SRAM_MAX_ALLOC) {
+            void *grown = multi_heap_realloc(pool, ptr, size);
+            if (grown) {
+                return grown;
+            }
+        }
+        old_size = multi_heap_get_allocated_size(pool, ptr);
+    } else {
+        // A block that outgrew the pool stays in PSRAM, ps_realloc avoids the copy when it can
+        old_size = heap_caps_get_allocated_size(ptr);
+        if (size > LV_TIERED_SRAM_MAX_ALLOC) {
+            void *grown = ps_realloc(ptr, size);
+            if (grown) {
+                psram_used += heap_caps_get_allocated_size(grown) - old_size;
+                if (psram_used > psram_high_water) {
+                    psram_high_water = psram_used;
+                }
+            }
+            return grown;
+        }
+    }
+
+    // The block changes tier
+    void *moved = lv_tiered_malloc(size);
+    if (!moved) {
+        return NULL;
+    }
+    memcpy(moved, ptr, old_size < size ? old_size : size);
+    lv_tiered_free(ptr);
+    return moved;
+}
+
+void getLvglMemStats(LvMemStats_t *stats)
+{
+    if (!stats) {
+        return;
+    }
+    memset(stats, 0, sizeof(LvMemStats_t));
+    if (pool) {
+        multi_heap_info_t info;
+        multi_heap_get_info(pool, &info);
+        stats->sram.size = LV_TIERED_SRAM_POOL_SIZE;
+        stats->sram.used = info.total_allocated_bytes;
+        stats->sram.highWater = info.total_free_bytes + info.total_allocated_bytes - info.minimum_free_bytes;
+        stats->sram.largestFree = info.largest_free_block;
+        stats->sram.blocks = info.allocated_blocks;
+        if (info.total_free_bytes) {
+            stats->sram.fragmentation = 100 - (uint64_t)info.largest_free_block * 100 / info.total_free_bytes;
+        }
+    }
+    stats->psram.used = psram_used;
+    stats->psram.highWater = psram_high_water;
+    stats->psram.largestFree = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+    stats->psram.blocks = psram_blocks;
+    stats->fallbacks = fallbacks;
+}
+
+#endif
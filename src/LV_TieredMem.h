@@ -0,0 +1,54 @@
+/**
+ * @file      LV_TieredMem.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2025  Shenzhen Xin Yuan Electronic Technology Co., Ltd
+ * @date      2025-03-18
+ * @note      lvgl 8 allocator, selected in lv_conf.h with LV_MEM_CUSTOM_ALLOC.
+ *            Small blocks (objects, styles, events, timers) come from a pool in
+ *            internal SRAM, larger ones and pool overflow go to PSRAM.
+ *            Included by lvgl's C sources, keep it free of C++ and lvgl headers.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Internal SRAM reserved for the small block pool, taken from the heap on the first allocation
+#ifndef LV_TIERED_SRAM_POOL_SIZE
+#define LV_TIERED_SRAM_POOL_SIZE        (48U * 1024U)
+#endif
+
+// Allocations up to this size are served from the pool
+#ifndef LV_TIERED_SRAM_MAX_ALLOC
+#define LV_TIERED_SRAM_MAX_ALLOC        (256U)
+#endif
+
+typedef struct __LvMemTier {
+    uint32_t size;                  //Pool size, 0 for the PSRAM tier which grows on demand
+    uint32_t used;                  //Bytes currently allocated
+    uint32_t highWater;             //Most bytes allocated at once
+    uint32_t largestFree;           //Largest block the pool can still serve
+    uint32_t blocks;                //Live allocations
+    uint8_t fragmentation;          //Percent of the free bytes outside the largest free block
+} LvMemTier_t;
+
+typedef struct __LvMemStats {
+    LvMemTier_t sram;
+    LvMemTier_t psram;
+    uint32_t fallbacks;             //Small allocations sent to PSRAM because the pool was full
+} LvMemStats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void *lv_tiered_malloc(size_t size);
+void lv_tiered_free(void *ptr);
+void *lv_tiered_realloc(void *ptr, size_t size);
+
+void getLvglMemStats(LvMemStats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -8,7 +8,10 @@
  */
 
 #include "LilyGo_AMOLED.h"
+#include "PixelKernel.h"
 #include <driver/gpio.h>
+#include <esp_system.h>
+#include <esp_heap_caps.h>
 
 #if ESP_ARDUINO_VERSION < ESP_ARDUINO_VERSION_VAL(3,0,0)
 #include <esp_adc_cal.h>
@@ -40,6 +43,10 @@
 #define LCD_CMD_SLPIN        (0x10) // Go into sleep mode (DC/DC, oscillator, scanning stopped, but memory keeps content)
 #endif
 
+#ifndef LCD_CMD_TEON
+#define LCD_CMD_TEON         (0x35) // Tearing effect line on
+#endif
+
 #ifndef LCD_CMD_BRIGHTNESS
 #define LCD_CMD_BRIGHTNESS   (0x51)
 #endif
@@ -47,12 +54,63 @@
 #define SEND_BUF_SIZE           (16384)
 #define TFT_SPI_MODE            SPI_MODE0
 #define DEFAULT_SPI_HANDLER    (SPI3_HOST)
+#define VSYNC_TIMEOUT_MS        (50)
+// Reset timing and passes come from the panel's DisplayTiming_t,
+// define AMOLED_INIT_PASSES to send the init sequence that many times on every panel
+#define PSRAM_QUEUE_DEPTH       (2)     //The driver bounces non-DMA buffers through internal RAM
+#define STAGE_QUEUE_DEPTH       (2)     //One staging buffer being filled, the other on the bus
+
+#if AMOLED_PERF_STATS
+#define PERF_TIME_BEGIN(name)           int64_t name = esp_timer_get_time()
+#define PERF_TIME_END(name, field)      _perf.field += (uint32_t)(esp_timer_get_time() - name)
+#define PERF_ADD(field, value)          _perf.field += (value)
+#define PERF_FLUSH_BEGIN()              do { _perf.flushCount++; _perf.flushStartUs = esp_timer_get_time(); } while (0)
+#define PERF_FLUSH_END()                _perf.flushUs += (uint32_t)(esp_timer_get_time() - _perf.flushStartUs)
+#else
+#define PERF_TIME_BEGIN(name)
+#define PERF_TIME_END(name, field)
+#define PERF_ADD(field, value)
+#define PERF_FLUSH_BEGIN()
+#define PERF_FLUSH_END()
+#endif
 
-LilyGo_AMOLED::LilyGo_AMOLED() : boards(NULL), _hasRTC(false), _disableTouch(false)
+LilyGo_AMOLED::LilyGo_AMOLED() : boards(NULL), _hasRTC(false), _disableTouch(false), _boardCached(false)
 {
     spiDev = NULL;
     pBuffer = NULL;
+    _shadowBuffer = NULL;
+    _shadowValid = false;
+    _fillBuffer = NULL;
+    _fillValue = 0;
+    _fillValid = false;
+    _fillScan = false;
+    _stageBuffer = NULL;
+    _stageIndex = 0;
     spi = NULL;
+    memset(&_dma, 0, sizeof(_dma));
+    _transCount = 0;
+    _flushReadyCb = NULL;
+    _flushReadyData = NULL;
+    _vsyncEnabled = false;
+    _scanAlongY = false;
+    _scanReverse = false;
+    _teSemaphore = NULL;
+    _teLastUs = 0;
+    _tePeriodUs = 0;
+    _teCount = 0;
+    _frameLastUs = 0;
+    memset(&_vsyncStats, 0, sizeof(_vsyncStats));
+    memset(&_initTrace, 0, sizeof(_initTrace));
+    _touchTask = NULL;
+    _touchSemaphore = NULL;
+    _touchStop = false;
+    _touchHead = 0;
+    _touchTail = 0;
+    _touchDropped = 0;
+    memset(&_touchLast, 0, sizeof(_touchLast));
+#if AMOLED_PERF_STATS
+    memset(&_perf, 0, sizeof(_perf));
+#endif
     _brightness = AMOLED_DEFAULT_BRIGHTNESS;
     // Prevent previously set hold
     switch (esp_sleep_get_wakeup_cause()) {
@@ -75,10 +133,37 @@ LilyGo_AMOLED::~LilyGo_AMOLED()
         pBuffer = NULL;
     }
 
+    if (_shadowBuffer) {
+        free(_shadowBuffer);
+        _shadowBuffer = NULL;
+    }
+
+    if (_fillBuffer) {
+        heap_caps_free(_fillBuffer);
+        _fillBuffer = NULL;
+    }
+
+    if (_stageBuffer) {
+        heap_caps_free(_stageBuffer);
+        _stageBuffer = NULL;
+    }
+
     if (spiDev) {
         spiDev->end();
         spiDev = NULL;
     }
+
+    if (_teSemaphore) {
+        enableVsync(false);
+        vSemaphoreDelete(_teSemaphore);
+        _teSemaphore = NULL;
+    }
+
+    if (_touchSemaphore) {
+        enableTouchInterrupt(false);
+        vSemaphoreDelete(_touchSemaphore);
+        _touchSemaphore = NULL;
+    }
 }
 
 const char *LilyGo_AMOLED::getName()
@@ -157,10 +242,16 @@ void LilyGo_AMOLED::enableTouch()
 uint8_t LilyGo_AMOLED::getPoint(int16_t *x, int16_t *y, uint8_t get_point )
 {
     uint8_t point = 0;
-    if (boards == &BOARD_AMOLED_147) {
-        point =  TouchDrvCHSC5816::getPoint(x, y);
-    } else if (boards == &BOARD_AMOLED_191 || boards == &BOARD_AMOLED_241 || boards == &BOARD_AMOLED_191_SPI) {
-        point =  TouchDrvCSTXXX::getPoint(x, y);
+    if (_touchTask) {
+        // The reader task owns the controller, report its latest sample
+        TouchSample_t last = _touchLast;
+        if (last.pressed) {
+            *x = last.x;
+            *y = last.y;
+            point = 1;
+        }
+    } else {
+        point = readTouchPoint(x, y);
     }
 
     // Disable touch, just return the touch press touch point Set to 0, does not actually disable touch
@@ -171,6 +262,17 @@ uint8_t LilyGo_AMOLED::getPoint(int16_t *x, int16_t *y, uint8_t get_point )
     return point;
 }
 
+uint8_t LilyGo_AMOLED::readTouchPoint(int16_t *x, int16_t *y)
+{
+    uint8_t point = 0;
+    if (boards == &BOARD_AMOLED_147) {
+        point =  TouchDrvCHSC5816::getPoint(x, y);
+    } else if (boards == &BOARD_AMOLED_191 || boards == &BOARD_AMOLED_241 || boards == &BOARD_AMOLED_191_SPI) {
+        point =  TouchDrvCSTXXX::getPoint(x, y);
+    }
+    return point;
+}
+
 uint16_t LilyGo_AMOLED::getBattVoltage(void)
 {
     if (boards) {
@@ -412,12 +514,18 @@ bool LilyGo_AMOLED::initBUS(DriverBusType type)
     }
 
     //reset display
+    const DisplayTiming_t *timing = boards->display.timing;
+    int64_t start = esp_timer_get_time();
     digitalWrite(boards->display.rst, HIGH);
-    delay(200);
+    delay(timing->powerSettleMs);
     digitalWrite(boards->display.rst, LOW);
-    delay(300);
+    delay(timing->resetPulseMs);
     digitalWrite(boards->display.rst, HIGH);
-    delay(200);
+    // A controller that was left awake needs the longer wait
+    delay(esp_reset_reason() == ESP_RST_POWERON ? timing->resetWaitMs : timing->resetAwakeWaitMs);
+    int64_t now = esp_timer_get_time();
+    _initTrace.resetUs = now - start;
+    start = now;
 
     if (type == QSPI_DRIVER) {
         spi_bus_config_t buscfg = {
@@ -442,6 +550,8 @@ bool LilyGo_AMOLED::initBUS(DriverBusType type)
             .spics_io_num = -1,
             .flags = SPI_DEVICE_HALFDUPLEX,
             .queue_size = 17,
+            .pre_cb = dma_ring_pre_callback,
+            .post_cb = dma_ring_post_callback,
         };
         esp_err_t ret = spi_bus_initialize(DEFAULT_SPI_HANDLER, &buscfg, SPI_DMA_CH_AUTO);
         if (ret != ESP_OK) {
@@ -451,39 +561,231 @@ bool LilyGo_AMOLED::initBUS(DriverBusType type)
         ret = spi_bus_add_device(DEFAULT_SPI_HANDLER, &devcfg, &spi);
         if (ret != ESP_OK) {
             log_e("spi_bus_add_device fail!");
+            // Nothing for releaseBoard() to find, free the bus here
+            spi_bus_free(DEFAULT_SPI_HANDLER);
             return false;
         }
+        dma_ring_init(&_dma, spi, boards->display.cs);
+        _dma.done = dmaFlushDone;
+        _dma.doneArg = this;
+        // Pattern buffer for fills, without it fills fall back to a full size buffer
+        if (!_fillBuffer) {
+            _fillBuffer = (uint16_t *)heap_caps_malloc(AMOLED_FILL_BUF_SIZE * sizeof(uint16_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+            if (!_fillBuffer) {
+                log_e("Failed to allocate the fill buffer");
+            }
+        }
     } else {
         pinMode(boards->display.d1, OUTPUT);    //set dc output
         spiDev = new SPIClass(HSPI);
         assert(spiDev);
         spiDev->begin(boards->display.sck, -1 /*miso */, boards->display.d0);
     }
-    // prevent initialization failure
-    int retry = 2;
-    while (retry--) {
-        const lcd_cmd_t *t = boards->display.initSequence;
-        for (uint32_t i = 0; i < boards->display.initSize; i++) {
-            writeCommand(t[i].addr, (uint8_t *)t[i].param, t[i].len & 0x1F);
-            if (t[i].len & 0x80) {
-                delay(120);
-            }
-            if (t[i].len & 0x20) {
-                delay(10);
-            }
+    now = esp_timer_get_time();
+    _initTrace.busUs = now - start;
+    start = now;
+
+#ifdef AMOLED_INIT_PASSES
+    int passes = AMOLED_INIT_PASSES;
+#else
+    int passes = timing->initPasses;
+#endif
+    _initTrace.commands = 0;
+    for (int i = 0; i < passes; i++) {
+        _initTrace.commands += writeInitSequence(boards->display.initSequence);
+    }
+    _initTrace.sequenceUs = esp_timer_get_time() - start;
+
+    log_i("Display init reset:%luus bus:%luus sequence:%luus commands:%lu",
+          (unsigned long)_initTrace.resetUs, (unsigned long)_initTrace.busUs,
+          (unsigned long)_initTrace.sequenceUs, (unsigned long)_initTrace.commands);
+    return true;
+}
+
+uint32_t LilyGo_AMOLED::writeInitSequence(const uint8_t *seq)
+{
+    uint32_t count = 0;
+    const uint8_t *p = seq;
+    while (*p != LCD_INIT_END) {
+        if (*p == LCD_INIT_DELAY) {
+            waitDMA();
+            delay(p[1]);
+            p += 2;
+            continue;
+        }
+        uint8_t length = p[0];
+        uint8_t cmd = p[1];
+        if (length > LCD_INIT_CMD_MAX) {
+            log_e("Invalid init sequence opcode 0x%02X", length);
+            break;
         }
+        // Commands are queued back to back on QSPI, the table stays in flash
+        if (spi) {
+            queueCommand(cmd, length ? p + 2 : NULL, length);
+        } else {
+            writeCommand(cmd, (uint8_t *)(p + 2), length);
+        }
+        p += 2 + length;
+        count++;
     }
+    waitDMA();
+    return count;
+}
+
+
+/*
+* The I2C devices found by the probe are kept in RTC memory that survives
+* deep sleep and software resets, so begin() can skip the probing on the
+* next boot. After a power cycle the memory holds garbage and the check word
+* fails. The board model is derived from the devices each time.
+* */
+#define BOARD_CACHE_MAGIC       (0x414D4F4C)
+
+// Devices found by probeDevices()
+#define BOARD_DEV_AXP2101       (0x01)  //1.47 inch PMU on GPIO 1/2
+#define BOARD_DEV_CST816        (0x02)  //1.91 inch touch on GPIO 3/2
+#define BOARD_DEV_PCF85063      (0x04)  //RTC of the 1.91 inch SPI board, same bus
+#define BOARD_DEV_SY6970        (0x08)  //2.41 inch PPM on GPIO 6/7
+
+typedef struct __BoardCache {
+    uint32_t magic;
+    uint8_t devices;
+    uint8_t reserved;
+    uint16_t check;
+} BoardCache_t;
+
+static RTC_NOINIT_ATTR BoardCache_t boardCache;
+
+static uint16_t boardCacheCheck(uint8_t devices)
+{
+    return (uint16_t)(((~devices & 0xFF) << 8 | devices) ^ 0xA55A);
+}
+
+static bool loadBoardCache(uint8_t *devices)
+{
+    if (boardCache.magic != BOARD_CACHE_MAGIC ||
+            boardCache.check != boardCacheCheck(boardCache.devices) ||
+            boardCache.devices == 0) {
+        return false;
+    }
+    *devices = boardCache.devices;
     return true;
 }
 
+static void saveBoardCache(uint8_t devices)
+{
+    boardCache.devices = devices;
+    boardCache.reserved = 0;
+    boardCache.check = boardCacheCheck(devices);
+    boardCache.magic = BOARD_CACHE_MAGIC;
+}
+
+// No device found means the 1.91 inch board without touch, a guess that is never cached
+static uint8_t boardFromDevices(uint8_t devices, bool *touch)
+{
+    *touch = true;
+    if (devices & BOARD_DEV_AXP2101) {
+        return LILYGO_AMOLED_147;
+    }
+    if (devices & BOARD_DEV_CST816) {
+        return (devices & BOARD_DEV_PCF85063) ? LILYGO_AMOLED_191_SPI : LILYGO_AMOLED_191;
+    }
+    if (devices & BOARD_DEV_SY6970) {
+        return LILYGO_AMOLED_241;
+    }
+    *touch = false;
+    return LILYGO_AMOLED_191;
+}
+
+void LilyGo_AMOLED::clearBoardCache()
+{
+    memset(&boardCache, 0, sizeof(boardCache));
+}
 
-bool LilyGo_AMOLED::begin()
+bool LilyGo_AMOLED::isBoardCached()
+{
+    return _boardCached;
+}
+
+bool LilyGo_AMOLED::begin(bool reprobe)
+{
+    uint8_t devices;
+    bool touch;
+
+    if (!reprobe && loadBoardCache(&devices)) {
+        uint8_t id = boardFromDevices(devices, &touch);
+        log_i("Use cached board model %u", id);
+        _boardCached = true;
+        if (beginBoard(id, touch)) {
+            return true;
+        }
+        log_e("Cached board model failed to start, probe again");
+        _boardCached = false;
+        // The probe needs the pins and buses the failed start took
+        releaseBoard();
+    }
+    clearBoardCache();
+
+    devices = probeDevices();
+    if (!beginBoard(boardFromDevices(devices, &touch), touch)) {
+        return false;
+    }
+    if (devices) {
+        saveBoardCache(devices);
+    }
+    return true;
+}
+
+bool LilyGo_AMOLED::beginBoard(uint8_t id, bool touch)
+{
+    switch (id) {
+    case LILYGO_AMOLED_147:
+        return beginAMOLED_147();
+    case LILYGO_AMOLED_191_SPI:
+        return beginAMOLED_191_SPI(touch);
+    case LILYGO_AMOLED_241:
+        return beginAMOLED_241();
+    default:
+        return beginAMOLED_191(touch);
+    }
+}
+
+// Undo what a beginAMOLED_xxx() set up, the board can be started again afterwards
+void LilyGo_AMOLED::releaseBoard()
+{
+    if (spi) {
+        waitDMA();
+        spi_bus_remove_device(spi);
+        spi_bus_free(DEFAULT_SPI_HANDLER);
+        spi = NULL;
+    }
+    if (spiDev) {
+        spiDev->end();
+        delete spiDev;
+        spiDev = NULL;
+    }
+    if (pBuffer) {
+        free(pBuffer);
+        pBuffer = NULL;
+    }
+    Wire.end();
+    if (boards) {
+        if (boards->PMICEnPins != -1) {
+            gpio_reset_pin((gpio_num_t)boards->PMICEnPins);
+        }
+        gpio_reset_pin((gpio_num_t)boards->display.rst);
+    }
+    _touchOnline = false;
+    boards = NULL;
+}
+
+uint8_t LilyGo_AMOLED::probeDevices()
 {
     //Try find 1.47 inch i2c devices
     Wire.begin(1, 2);
     Wire.beginTransmission(AXP2101_SLAVE_ADDRESS);
     if (Wire.endTransmission() == 0) {
-        return beginAMOLED_147();
+        return BOARD_DEV_AXP2101;
     }
 
     log_e("Unable to detect 1.47-inch board model!");
@@ -502,10 +804,10 @@ bool LilyGo_AMOLED::begin()
         Wire.beginTransmission(0x51);
         if (Wire.endTransmission() == 0) {
             log_i("Detect 1.91-inch SPI board model!");
-            return beginAMOLED_191_SPI(true);
+            return BOARD_DEV_CST816 | BOARD_DEV_PCF85063;
         } else {
             log_i("Detect 1.91-inch QSPI board model!");
-            return beginAMOLED_191(true);
+            return BOARD_DEV_CST816;
         }
     }
     log_e("Unable to detect 1.91-inch touch board model!");
@@ -518,7 +820,7 @@ bool LilyGo_AMOLED::begin()
     Wire.begin(6, 7);
     Wire.beginTransmission(SY6970_SLAVE_ADDRESS);
     if (Wire.endTransmission() == 0) {
-        return beginAMOLED_241();
+        return BOARD_DEV_SY6970;
     }
     log_e("Unable to detect 2.41-inch touch board model!");
 
@@ -527,7 +829,7 @@ bool LilyGo_AMOLED::begin()
 
     log_e("Begin 1.91-inch no touch board model");
 
-    return beginAMOLED_191(false);
+    return 0;
 }
 
 
@@ -540,12 +842,16 @@ bool LilyGo_AMOLED::beginAMOLED_191(bool touchFunc)
 {
     boards = &BOARD_AMOLED_191;
 
-    initBUS();
+    if (!initBUS()) {
+        return false;
+    }
 
     if (touchFunc && boards->touch) {
         if (boards->touch->sda != -1 && boards->touch->scl != -1) {
             Wire.begin(boards->touch->sda, boards->touch->scl);
-            deviceScan(&Wire, &Serial);
+            if (!_boardCached) {
+                deviceScan(&Wire, &Serial);
+            }
 
             // Try to find touch device
             Wire.beginTransmission(CST816_SLAVE_ADDRESS);
@@ -576,12 +882,16 @@ bool LilyGo_AMOLED::beginAMOLED_191_SPI(bool touchFunc)
 {
     boards = &BOARD_AMOLED_191_SPI;
 
-    initBUS(SPI_DRIVER);
+    if (!initBUS(SPI_DRIVER)) {
+        return false;
+    }
 
     if (boards->pmu) {
         uint8_t slaveAddress = 0;
         Wire.begin(boards->pmu->sda, boards->pmu->scl);
-        deviceScan(&Wire, &Serial);
+        if (!_boardCached) {
+            deviceScan(&Wire, &Serial);
+        }
 
         Wire.beginTransmission(SY6970_SLAVE_ADDRESS);
         if (Wire.endTransmission() == 0) {
@@ -617,7 +927,9 @@ bool LilyGo_AMOLED::beginAMOLED_191_SPI(bool touchFunc)
     if (touchFunc && boards->touch) {
         if (boards->touch->sda != -1 && boards->touch->scl != -1) {
             Wire.begin(boards->touch->sda, boards->touch->scl);
-            deviceScan(&Wire, &Serial);
+            if (!_boardCached) {
+                deviceScan(&Wire, &Serial);
+            }
 
             // Try to find touch device
             Wire.beginTransmission(CST816_SLAVE_ADDRESS);
@@ -652,7 +964,9 @@ bool LilyGo_AMOLED::beginAMOLED_241(bool disable_sd, bool disable_state_led)
 {
     boards = &BOARD_AMOLED_241;
 
-    initBUS();
+    if (!initBUS()) {
+        return false;
+    }
 
     if (boards->pmu) {
         Wire.begin(boards->pmu->sda, boards->pmu->scl);
@@ -762,11 +1076,13 @@ bool LilyGo_AMOLED::beginAMOLED_147()
         return false;
     }
 
-    if (ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_INFO) {
+    if (!_boardCached && ARDUHAL_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_INFO) {
         deviceScan(&Wire, &Serial);
     }
 
-    initBUS();
+    if (!initBUS()) {
+        return false;
+    }
 
 
     if (boards->display.frameBufferSize) {
@@ -812,6 +1128,7 @@ bool LilyGo_AMOLED::beginAMOLED_147()
 void LilyGo_AMOLED::writeCommand(uint32_t cmd, uint8_t *pdat, uint32_t length)
 {
     if (spiDev) {
+        PERF_TIME_BEGIN(start);
         // Write spi command
         setCS();
         spiDev->beginTransaction(SPISettings(boards->display.freq, MSBFIRST, TFT_SPI_MODE));
@@ -830,10 +1147,12 @@ void LilyGo_AMOLED::writeCommand(uint32_t cmd, uint8_t *pdat, uint32_t length)
             spiDev->endTransaction();
             clrCS();
         }
+        PERF_TIME_END(start, pollingUs);
         return;
     }
 
     // QSPI
+    waitDMA();
     setCS();
     spi_transaction_t t;
     memset(&t, 0, sizeof(t));
@@ -847,7 +1166,10 @@ void LilyGo_AMOLED::writeCommand(uint32_t cmd, uint8_t *pdat, uint32_t length)
         t.tx_buffer = NULL;
         t.length = 0;
     }
+    PERF_TIME_BEGIN(start);
     spi_device_polling_transmit(spi, &t);
+    PERF_TIME_END(start, pollingUs);
+    _transCount++;
     clrCS();
 }
 
@@ -865,6 +1187,8 @@ uint8_t LilyGo_AMOLED::getBrightness()
 
 void LilyGo_AMOLED::setAddrWindow(uint16_t xs, uint16_t ys, uint16_t xe, uint16_t ye)
 {
+    // The pixels that follow bypass the shadow buffer
+    _shadowValid = false;
     xs += _offset_x;
     ys += _offset_y;
     xe += _offset_x;
@@ -901,13 +1225,21 @@ void LilyGo_AMOLED::setAddrWindow(uint16_t xs, uint16_t ys, uint16_t xe, uint16_
 // Push (aka write pixel) colours to the TFT (use setAddrWindow() first)
 void LilyGo_AMOLED::pushColors(uint16_t *data, uint32_t len)
 {
+    PERF_ADD(pixelCount, len);
     if (spiDev) {
+        PERF_TIME_BEGIN(start);
         setCS();
         spiDev->beginTransaction(SPISettings(boards->display.freq, MSBFIRST, TFT_SPI_MODE));
         digitalWrite(boards->display.d1, HIGH);
-        spiDev->writeBytes((uint8_t *)data, len * sizeof(uint16_t));
+        if (_swapBytes) {
+            // writePixels sends every 16 bit word MSB first
+            spiDev->writePixels(data, len * sizeof(uint16_t));
+        } else {
+            spiDev->writeBytes((uint8_t *)data, len * sizeof(uint16_t));
+        }
         spiDev->endTransaction();
         clrCS();
+        PERF_TIME_END(start, pollingUs);
         return;
     }
 
@@ -915,6 +1247,7 @@ void LilyGo_AMOLED::pushColors(uint16_t *data, uint32_t len)
     uint16_t *p = data;
     assert(p);
     assert(spi);
+    waitDMA();
     setCS();
     do {
         size_t chunk_size = len;
@@ -934,9 +1267,20 @@ void LilyGo_AMOLED::pushColors(uint16_t *data, uint32_t len)
         if (chunk_size > SEND_BUF_SIZE) {
             chunk_size = SEND_BUF_SIZE;
         }
-        t.base.tx_buffer = p;
+        if (_swapBytes) {
+            if (chunk_size > AMOLED_STAGE_SIZE) {
+                chunk_size = AMOLED_STAGE_SIZE;
+            }
+            pixel_swap(_stageBuffer, p, chunk_size);
+            t.base.tx_buffer = _stageBuffer;
+        } else {
+            t.base.tx_buffer = p;
+        }
         t.base.length = chunk_size * 16;
+        PERF_TIME_BEGIN(start);
         spi_device_polling_transmit(spi, (spi_transaction_t *)&t);
+        PERF_TIME_END(start, pollingUs);
+        _transCount++;
         len -= chunk_size;
         p += chunk_size;
     } while (len > 0);
@@ -945,76 +1289,854 @@ void LilyGo_AMOLED::pushColors(uint16_t *data, uint32_t len)
 
 void LilyGo_AMOLED::pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data)
 {
+    PERF_FLUSH_BEGIN();
+    pushSplit(x, y, width, hight, data);
+    PERF_FLUSH_END();
+}
 
-    if (boards->display.frameBufferSize) {
-        assert(pBuffer);
-        uint16_t _x = this->height() - (y + hight);
-        uint16_t _y = x;
-        uint16_t _h = width;
-        uint16_t _w = hight;
-        uint16_t *p = data;
-        uint32_t cum = 0;
-        for (uint16_t j = 0; j < width; j++) {
-            for (uint16_t i = 0; i < hight; i++) {
-                pBuffer[cum] = ((uint16_t)p[width * (hight - i - 1) + j]);
-                cum++;
-            }
-        }
-        setAddrWindow(_x, _y, _x + _w - 1, _y + _h - 1);
-        pushColors(pBuffer, width * hight);
+void LilyGo_AMOLED::pushSplit(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data)
+{
+    if (!_vsyncEnabled || !_scanAlongY || boards->display.frameBufferSize) {
+        pushArea(x, y, width, hight, data);
+        return;
+    }
+
+    // Send the rows the panel has already scanned in this frame first,
+    // the rows still ahead of the scan line are sent afterwards
+    int32_t line = getScanLine();
+    if (line <= y || line >= y + hight) {
+        pushArea(x, y, width, hight, data);
+        return;
+    }
+
+    uint16_t top = _scanReverse ? line + 1 - y : line - y;
+    if (top == 0 || top >= hight) {
+        pushArea(x, y, width, hight, data);
+        return;
+    }
+
+    _vsyncStats.splitCount++;
+    if (_scanReverse) {
+        pushArea(x, y + top, width, hight - top, data + width * top);
+        pushArea(x, y, width, top, data);
     } else {
+        pushArea(x, y, width, top, data);
+        pushArea(x, y + top, width, hight - top, data + width * top);
+    }
+}
+
+void LilyGo_AMOLED::pushArea(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data)
+{
+    if (!spi) {
         setAddrWindow(x, y, x + width - 1, y + hight - 1);
         pushColors(data, width * hight);
+        return;
     }
+
+    waitDMA();
+    queueArea(x, y, width, hight, data, false);
+    waitDMA();
 }
 
-void LilyGo_AMOLED::pushColorsDMA(uint16_t *data, uint32_t len)
+void LilyGo_AMOLED::queueArea(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data, bool notify)
+{
+    if (!boards->display.frameBufferSize) {
+        queueWindow(x, y, x + width - 1, y + hight - 1);
+        queueData(data, width * hight, notify);
+        return;
+    }
+
+    // The frame buffer holds the area rotated into panel coordinates
+    uint16_t _x = this->height() - (y + hight);
+    uint16_t _y = x;
+    data = rotateToFrameBuffer(x, y, width, hight, data);
+
+    if (_shadowBuffer) {
+        if (_shadowValid) {
+            queueFrameDiff(_x, _y, hight, width, notify);
+            return;
+        }
+        // Nothing to compare against yet, send everything and start tracking
+        for (uint16_t row = 0; row < width; row++) {
+            memcpy(_shadowBuffer + (uint32_t)(_y + row) * this->height() + _x,
+                   data + (uint32_t)row * hight, hight * sizeof(uint16_t));
+        }
+        _shadowValid = (width == this->width() && hight == this->height());
+    }
+
+    queueWindow(_x, _y, _x + hight - 1, _y + width - 1);
+    queueData(data, width * hight, notify);
+}
+
+/*
+* Compare the rotated area in pBuffer with the shadow two rows at a time,
+* consecutive changed row pairs form a band sent with a single window.
+* Bands keep the 2 pixel alignment lv_rounder_cb uses for the other panels.
+* One band is held back so that only the last one notifies the callback.
+* */
+void LilyGo_AMOLED::queueFrameDiff(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, bool notify)
+{
+    bool pending = false;
+    uint16_t pendingTop = 0, pendingBottom = 0, pendingLeft = 0, pendingRight = 0;
+    bool open = false;
+    uint16_t top = 0, left = 0, right = 0;
+
+    // One pass past the end closes the last band
+    for (uint32_t row = 0; row < hight + 2U; row += 2) {
+        bool changed = false;
+        uint16_t first = width, last = 0;
+        for (uint32_t k = row; k < row + 2 && k < hight; k++) {
+            uint32_t f, l;
+            const uint16_t *src = pBuffer + (uint32_t)k * width;
+            const uint16_t *shadow = _shadowBuffer + (uint32_t)(y + k) * this->height() + x;
+            if (pixel_diff_span(src, shadow, width, &f, &l)) {
+                changed = true;
+                first = f < first ? f : first;
+                last = l > last ? l : last;
+            }
+        }
+
+        if (changed) {
+            first &= ~1;
+            last |= 1;
+            if (last >= width) {
+                last = width - 1;
+            }
+            if (open) {
+                left = first < left ? first : left;
+                right = last > right ? last : right;
+            } else {
+                open = true;
+                top = row;
+                left = first;
+                right = last;
+            }
+            continue;
+        }
+
+        if (open) {
+            if (pending) {
+                queueBand(x, y, width, pendingTop, pendingBottom, pendingLeft, pendingRight, false);
+            }
+            pending = true;
+            pendingTop = top;
+            pendingBottom = (row < hight ? row : hight) - 1;
+            pendingLeft = left;
+            pendingRight = right;
+            open = false;
+        }
+    }
+
+    if (pending) {
+        queueBand(x, y, width, pendingTop, pendingBottom, pendingLeft, pendingRight, notify);
+    } else if (notify && _flushReadyCb) {
+        // Nothing changed, the frame is done already
+        _flushReadyCb(_flushReadyData);
+    }
+}
+
+void LilyGo_AMOLED::queueBand(uint16_t x, uint16_t y, uint16_t width, uint16_t top, uint16_t bottom,
+                              uint16_t left, uint16_t right, bool notify)
+{
+    uint16_t span = right - left + 1;
+    uint16_t *dst = pBuffer + (uint32_t)top * width;
+
+    for (uint16_t row = top; row <= bottom; row++) {
+        uint16_t *src = pBuffer + (uint32_t)row * width + left;
+        memcpy(_shadowBuffer + (uint32_t)(y + row) * this->height() + x + left, src, span * sizeof(uint16_t));
+        // Pack the spans of the band back to back, the writes never pass the row being read
+        if (span != width) {
+            memmove(dst, src, span * sizeof(uint16_t));
+            dst += span;
+        }
+    }
+
+    queueWindow(x + left, y + top, x + right, y + bottom);
+    queueData(pBuffer + (uint32_t)top * width, (uint32_t)span * (bottom - top + 1), notify);
+}
+
+uint16_t *LilyGo_AMOLED::rotateToFrameBuffer(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data)
+{
+    assert(pBuffer);
+    // 90 degree clockwise, done in cache sized tiles instead of walking PSRAM column by column
+    PERF_TIME_BEGIN(start);
+    pixel_rotate(data, pBuffer, width, hight, 1);
+    PERF_TIME_END(start, rotateUs);
+    return pBuffer;
+}
+
+void LilyGo_AMOLED::pushColorsDMA(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data)
+{
+    if (!spi) {
+        setAddrWindow(x, y, x + width - 1, y + hight - 1);
+        pushColorsDMA(data, width * hight);
+        return;
+    }
+
+    // The previous flush may still be reading the frame buffer
+    waitDMA();
+    // Finished by the SPI callback of the last chunk
+    PERF_FLUSH_BEGIN();
+    queueArea(x, y, width, hight, data, true);
+
+    // Without a completion callback keep the blocking behavior
+    if (!_flushReadyCb) {
+        waitDMA();
+    }
+}
+
+void IRAM_ATTR LilyGo_AMOLED::dmaFlushDone(void *arg)
+{
+    LilyGo_AMOLED *self = (LilyGo_AMOLED *)arg;
+#if AMOLED_PERF_STATS
+    self->_perf.flushUs += (uint32_t)(esp_timer_get_time() - self->_perf.flushStartUs);
+#endif
+    if (self->_flushReadyCb) {
+        self->_flushReadyCb(self->_flushReadyData);
+    }
+}
+
+bool LilyGo_AMOLED::setFlushReadyCallback(void (*cb)(void *user_data), void *user_data)
+{
+    if (!spi) {
+        return false;
+    }
+    waitDMA();
+    _flushReadyCb = cb;
+    _flushReadyData = user_data;
+    return true;
+}
+
+void LilyGo_AMOLED::waitDMA()
 {
     if (!spi) return;
 
-    bool first_send = true;
-    setCS();
+    PERF_TIME_BEGIN(start);
+    dma_ring_wait(&_dma);
+    PERF_TIME_END(start, dmaWaitUs);
+}
 
+spi_transaction_ext_t *LilyGo_AMOLED::acquireSlot(uint8_t flags, uint8_t depth)
+{
+    PERF_TIME_BEGIN(start);
+    spi_transaction_ext_t *t = dma_ring_acquire(&_dma, flags, depth);
+    PERF_TIME_END(start, dmaWaitUs);
+    return t;
+}
+
+void LilyGo_AMOLED::queueSlot(spi_transaction_ext_t *t)
+{
+    if (dma_ring_queue(&_dma, t)) {
+        _transCount++;
+    }
+}
+
+// Parameters up to 4 bytes are copied, longer ones must stay valid until the transaction is done
+void LilyGo_AMOLED::queueCommand(uint32_t cmd, const uint8_t *pdat, uint32_t length)
+{
+    spi_transaction_ext_t *t = acquireSlot(DMA_SLOT_BEGIN | DMA_SLOT_END);
+    t->base.flags = SPI_TRANS_MULTILINE_CMD | SPI_TRANS_MULTILINE_ADDR;
+    t->base.cmd = 0x02;
+    t->base.addr = cmd << 8;
+    if (length <= 4) {
+        t->base.flags |= SPI_TRANS_USE_TXDATA;
+        if (length) {
+            memcpy(t->base.tx_data, pdat, length);
+        }
+    } else {
+        t->base.tx_buffer = pdat;
+    }
+    t->base.length = 8 * length;
+    queueSlot(t);
+}
+
+void LilyGo_AMOLED::queueWindow(uint16_t xs, uint16_t ys, uint16_t xe, uint16_t ye)
+{
+    xs += _offset_x;
+    ys += _offset_y;
+    xe += _offset_x;
+    ye += _offset_y;
+
+    // CASET and RASET, RAMWR is sent as the command of the first pixel chunk
+    const uint32_t cmd[2] = {LCD_CMD_CASET, LCD_CMD_RASET};
+    const uint16_t start[2] = {xs, ys};
+    const uint16_t end[2] = {xe, ye};
+    for (int i = 0; i < 2; i++) {
+        uint8_t param[4] = {
+            (uint8_t)((start[i] >> 8) & 0xFF),
+            (uint8_t)(start[i] & 0xFF),
+            (uint8_t)((end[i] >> 8) & 0xFF),
+            (uint8_t)(end[i] & 0xFF)
+        };
+        queueCommand(cmd[i], param, 4);
+    }
+}
+
+void LilyGo_AMOLED::queuePixels(uint16_t *data, uint32_t len, bool notify)
+{
+    queueRun(data, len, false, true, true, notify);
+}
+
+/*
+* Queue part of a RAMWR pixel stream. first starts the stream with the RAMWR
+* command and asserts CS, last releases CS after the final chunk.
+* With repeat the chunks all point at the fill pattern buffer.
+* With swapped bytes every chunk is swapped into a staging buffer first.
+* */
+void LilyGo_AMOLED::queueRun(const uint16_t *data, uint32_t len, bool repeat, bool first, bool last, bool notify)
+{
+    // Each transaction from PSRAM holds an internal bounce buffer, keep few of them in flight
+    uint8_t depth = (repeat || esp_ptr_dma_capable(data)) ? AMOLED_DMA_QUEUE_SIZE : PSRAM_QUEUE_DEPTH;
+    uint32_t max_chunk = repeat ? AMOLED_FILL_BUF_SIZE : SEND_BUF_SIZE;
+    const uint16_t *src = repeat ? _fillBuffer : data;
+    bool staged = !repeat && _swapBytes;
+    if (staged) {
+        // Waiting for all but the newest transaction frees the buffer about to be filled
+        depth = STAGE_QUEUE_DEPTH;
+        max_chunk = AMOLED_STAGE_SIZE;
+    }
+
+    PERF_ADD(pixelCount, len);
     while (len > 0) {
         size_t chunk_size = len;
-        if (chunk_size > SEND_BUF_SIZE) {
-            chunk_size = SEND_BUF_SIZE;
+        if (chunk_size > max_chunk) {
+            chunk_size = max_chunk;
         }
+        len -= chunk_size;
 
-        spi_transaction_ext_t t = {0};
-        memset(&t, 0, sizeof(t));
+        uint8_t flags = 0;
+        if (first) {
+            flags |= DMA_SLOT_BEGIN;
+        }
+        if (last && len == 0) {
+            flags |= notify ? (DMA_SLOT_END | DMA_SLOT_FLUSH) : DMA_SLOT_END;
+        }
 
-        if (first_send) {
-            t.base.flags = SPI_TRANS_MODE_QIO;
-            t.base.cmd = 0x32;
-            t.base.addr = 0x002C00;
-            first_send = 0;
+        spi_transaction_ext_t *t = acquireSlot(flags, depth);
+        if (first) {
+            t->base.flags = SPI_TRANS_MODE_QIO;
+            t->base.cmd = 0x32;
+            t->base.addr = 0x002C00;
+            first = false;
         } else {
-            t.base.flags = SPI_TRANS_MODE_QIO | SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR | SPI_TRANS_VARIABLE_DUMMY;
-            t.command_bits = 0;
-            t.address_bits = 0;
-            t.dummy_bits = 0;
+            t->base.flags = SPI_TRANS_MODE_QIO | SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR | SPI_TRANS_VARIABLE_DUMMY;
+            t->command_bits = 0;
+            t->address_bits = 0;
+            t->dummy_bits = 0;
+        }
+        if (staged) {
+            uint16_t *stage = _stageBuffer + (uint32_t)_stageIndex * AMOLED_STAGE_SIZE;
+            _stageIndex ^= 1;
+            pixel_swap(stage, src, chunk_size);
+            t->base.tx_buffer = stage;
+        } else {
+            t->base.tx_buffer = src;
         }
+        t->base.length = chunk_size * 16;
+        queueSlot(t);
 
-        t.base.tx_buffer = data;
-        t.base.length = chunk_size * 16;
+        if (!repeat) {
+            src += chunk_size;
+        }
+    }
+}
 
-        esp_err_t ret = spi_device_queue_trans(spi, &t.base, portMAX_DELAY);
-        if (ret != ESP_OK) {
-            log_e("DMA transfer failed!");
+/*
+* Send a pixel buffer, optionally split into uniform and textured runs.
+* Long uniform runs are streamed from the fill pattern buffer so the DMA
+* only copies the textured pixels out of PSRAM.
+* */
+void LilyGo_AMOLED::queueData(uint16_t *data, uint32_t len, bool notify)
+{
+    if (!_fillScan || !_fillBuffer || len < AMOLED_FILL_MIN_RUN) {
+        queuePixels(data, len, notify);
+        return;
+    }
+
+    bool first = true;
+    uint32_t start = 0;
+    uint32_t i = 0;
+    while (i < len) {
+        uint32_t run = pixel_run_length(data + i, len - i);
+        if (run >= AMOLED_FILL_MIN_RUN) {
+            if (i > start) {
+                queueRun(data + start, i - start, false, first, false, false);
+                first = false;
+            }
+            setFillPattern(_swapBytes ? (uint16_t)((data[i] << 8) | (data[i] >> 8)) : data[i]);
+            queueRun(NULL, run, true, first, i + run == len, notify);
+            first = false;
+            start = i + run;
         }
+        i += run;
+    }
+    if (start < len) {
+        queueRun(data + start, len - start, false, first, true, notify);
+    }
+}
 
-        spi_transaction_t *trans_result;
-        ret = spi_device_get_trans_result(spi, &trans_result, portMAX_DELAY);
-        if (ret != ESP_OK) {
-            log_e("DMA SPI transfer failed!");
+// value is in bus byte order, queued fills still reading the old pattern are drained first
+bool LilyGo_AMOLED::setFillPattern(uint16_t value)
+{
+    if (!_fillBuffer) {
+        return false;
+    }
+    if (_fillValid && _fillValue == value) {
+        return true;
+    }
+    waitDMA();
+    for (uint32_t i = 0; i < AMOLED_FILL_BUF_SIZE; i++) {
+        _fillBuffer[i] = value;
+    }
+    _fillValue = value;
+    _fillValid = true;
+    return true;
+}
+
+void LilyGo_AMOLED::pushRepeat(uint16_t color, uint32_t len)
+{
+    uint16_t swapped = (uint16_t)((color << 8) | (color >> 8));
+    if (spiDev) {
+        setCS();
+        spiDev->beginTransaction(SPISettings(boards->display.freq, MSBFIRST, TFT_SPI_MODE));
+        digitalWrite(boards->display.d1, HIGH);
+        PERF_TIME_BEGIN(start);
+        spiDev->writePattern((uint8_t *)&swapped, sizeof(swapped), len);
+        spiDev->endTransaction();
+        clrCS();
+        PERF_TIME_END(start, pollingUs);
+        PERF_ADD(pixelCount, len);
+        return;
+    }
+
+    if (!spi || !setFillPattern(swapped)) {
+        LilyGo_Display::pushRepeat(color, len);
+        return;
+    }
+    queueRun(NULL, len, true, true, true, false);
+    waitDMA();
+}
+
+void LilyGo_AMOLED::fillRect(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t color)
+{
+    if (!spi || !_fillBuffer) {
+        LilyGo_Display::fillRect(x, y, width, hight, color);
+        return;
+    }
+
+    // The panel content no longer matches the shadow
+    _shadowValid = false;
+    setFillPattern((uint16_t)((color << 8) | (color >> 8)));
+    if (boards->display.frameBufferSize) {
+        uint16_t _x = this->height() - (y + hight);
+        uint16_t _y = x;
+        queueWindow(_x, _y, _x + hight - 1, _y + width - 1);
+    } else {
+        queueWindow(x, y, x + width - 1, y + hight - 1);
+    }
+    queueRun(NULL, (uint32_t)width * hight, true, true, true, false);
+}
+
+bool LilyGo_AMOLED::enableFillScan(bool enable)
+{
+    if (!spi || !_fillBuffer) {
+        return false;
+    }
+    _fillScan = enable;
+    return true;
+}
+
+bool LilyGo_AMOLED::setSwapBytes(bool swap)
+{
+    if (spiDev) {
+        _swapBytes = swap;
+        return true;
+    }
+    if (!spi) {
+        return false;
+    }
+    // Queued chunks may still be reading from the staging buffers or the source
+    waitDMA();
+    if (swap && !_stageBuffer) {
+        _stageBuffer = (uint16_t *)heap_caps_malloc(2 * AMOLED_STAGE_SIZE * sizeof(uint16_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        if (!_stageBuffer) {
+            log_e("Failed to allocate the staging buffers");
+            return false;
         }
+    }
+    _swapBytes = swap;
+    return true;
+}
 
-        data += chunk_size;
-        len -= chunk_size;
+void LilyGo_AMOLED::pushColorsDMA(uint16_t *data, uint32_t len)
+{
+    if (!spi) return;
+
+    PERF_FLUSH_BEGIN();
+    queueData(data, len, true);
+
+    // Without a completion callback keep the blocking behavior
+    if (!_flushReadyCb) {
+        waitDMA();
     }
+}
 
-    clrCS();
+bool LilyGo_AMOLED::enableFrameDiff(bool enable)
+{
+    if (!boards || !boards->display.frameBufferSize || !spi) {
+        return false;
+    }
+    if (!enable) {
+        if (_shadowBuffer) {
+            free(_shadowBuffer);
+            _shadowBuffer = NULL;
+        }
+        _shadowValid = false;
+        return true;
+    }
+    if (_shadowBuffer) {
+        return true;
+    }
+    if (psramFound()) {
+        _shadowBuffer = (uint16_t *)ps_malloc(boards->display.frameBufferSize);
+    } else {
+        _shadowBuffer = (uint16_t *)malloc(boards->display.frameBufferSize);
+    }
+    if (!_shadowBuffer) {
+        log_e("Failed to allocate the shadow frame buffer");
+        return false;
+    }
+    // The next full frame is sent as is and fills the shadow
+    _shadowValid = false;
+    return true;
+}
+
+bool LilyGo_AMOLED::isFrameDiffEnabled()
+{
+    return _shadowBuffer != NULL;
+}
+
+bool LilyGo_AMOLED::getPerfStats(DisplayPerfStats_t *stats)
+{
+    if (!stats) {
+        return false;
+    }
+    memset(stats, 0, sizeof(DisplayPerfStats_t));
+    stats->transactionCount = _transCount;
+    if (boards) {
+        uint8_t lanes = spi ? 4 : 1;
+        stats->busMBs = (float)boards->display.freq * lanes / 8 / 1000000.0;
+    }
+#if AMOLED_PERF_STATS
+    stats->elapsedUs = (uint32_t)(esp_timer_get_time() - _perf.resetUs);
+    stats->flushCount = _perf.flushCount;
+    stats->pixelCount = _perf.pixelCount;
+    stats->pollingUs = _perf.pollingUs;
+    stats->dmaWaitUs = _perf.dmaWaitUs;
+    stats->rotateUs = _perf.rotateUs;
+    stats->flushUs = _perf.flushUs;
+    if (stats->flushUs) {
+        stats->throughputMBs = (float)(stats->pixelCount * sizeof(uint16_t)) / stats->flushUs;
+    }
+    if (stats->elapsedUs) {
+        stats->flushRate = stats->flushCount * 1000000.0 / stats->elapsedUs;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void LilyGo_AMOLED::resetPerfStats()
+{
+    _transCount = 0;
+#if AMOLED_PERF_STATS
+    memset(&_perf, 0, sizeof(_perf));
+    _perf.resetUs = esp_timer_get_time();
+#endif
+}
+
+void LilyGo_AMOLED::dumpPerfStats(Stream &stream)
+{
+    DisplayPerfStats_t perf;
+    if (getPerfStats(&perf)) {
+        stream.printf("[display] %.1fs flush:%lu %.1f/s px:%llu tx:%lu\n",
+                      perf.elapsedUs / 1000000.0, (unsigned long)perf.flushCount, perf.flushRate,
+                      (unsigned long long)perf.pixelCount, (unsigned long)perf.transactionCount);
+        stream.printf("[display] busy:%lums poll:%lums wait:%lums rotate:%lums %.1f of %.1fMB/s\n",
+                      (unsigned long)(perf.flushUs / 1000), (unsigned long)(perf.pollingUs / 1000),
+                      (unsigned long)(perf.dmaWaitUs / 1000), (unsigned long)(perf.rotateUs / 1000),
+                      perf.throughputMBs, perf.busMBs);
+    } else {
+        stream.printf("[display] tx:%lu, build with AMOLED_PERF_STATS=1 for details\n",
+                      (unsigned long)perf.transactionCount);
+    }
+
+    if (_vsyncEnabled) {
+        stream.printf("[vsync] te:%lu period:%luus frames:%lu wait:%luus split:%lu timeout:%lu\n",
+                      (unsigned long)_teCount, (unsigned long)_tePeriodUs,
+                      (unsigned long)_vsyncStats.frameCount, (unsigned long)_vsyncStats.waitUs,
+                      (unsigned long)_vsyncStats.splitCount, (unsigned long)_vsyncStats.timeoutCount);
+    }
+
+    stream.printf("[init] reset:%luus bus:%luus sequence:%luus commands:%lu\n",
+                  (unsigned long)_initTrace.resetUs, (unsigned long)_initTrace.busUs,
+                  (unsigned long)_initTrace.sequenceUs, (unsigned long)_initTrace.commands);
+}
+
+uint32_t LilyGo_AMOLED::getTransactionCount()
+{
+    return _transCount;
+}
+
+void LilyGo_AMOLED::resetTransactionCount()
+{
+    _transCount = 0;
+}
+
+void IRAM_ATTR LilyGo_AMOLED::teInterruptHandler(void *arg)
+{
+    LilyGo_AMOLED *self = (LilyGo_AMOLED *)arg;
+    int64_t now = esp_timer_get_time();
+    if (self->_teLastUs) {
+        uint32_t period = (uint32_t)(now - self->_teLastUs);
+        self->_tePeriodUs = self->_tePeriodUs ? (self->_tePeriodUs * 7 + period) / 8 : period;
+    }
+    self->_teLastUs = now;
+    self->_teCount++;
+
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    xSemaphoreGiveFromISR(self->_teSemaphore, &xHigherPriorityTaskWoken);
+    if (xHigherPriorityTaskWoken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+void IRAM_ATTR LilyGo_AMOLED::touchInterruptHandler(void *arg)
+{
+    LilyGo_AMOLED *self = (LilyGo_AMOLED *)arg;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    xSemaphoreGiveFromISR(self->_touchSemaphore, &xHigherPriorityTaskWoken);
+    if (xHigherPriorityTaskWoken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+/*
+* Sleep until the controller pulls IRQ, then read it every
+* AMOLED_TOUCH_ACTIVE_MS until the finger is lifted. The release is
+* queued as a sample too, so the consumer never misses the end of a press.
+* */
+void LilyGo_AMOLED::touchReaderTask(void *arg)
+{
+    LilyGo_AMOLED *self = (LilyGo_AMOLED *)arg;
+    bool pressed = false;
+    int16_t x = 0, y = 0;
+
+    while (!self->_touchStop) {
+        xSemaphoreTake(self->_touchSemaphore, pressed ? pdMS_TO_TICKS(AMOLED_TOUCH_ACTIVE_MS) : portMAX_DELAY);
+        if (self->_touchStop) {
+            break;
+        }
+        if (self->readTouchPoint(&x, &y)) {
+            self->pushTouchSample(x, y, true);
+            pressed = true;
+        } else if (pressed) {
+            self->pushTouchSample(self->_touchLast.x, self->_touchLast.y, false);
+            pressed = false;
+        }
+    }
+
+    self->_touchTask = NULL;
+    vTaskDelete(NULL);
+}
+
+void LilyGo_AMOLED::pushTouchSample(int16_t x, int16_t y, bool pressed)
+{
+    TouchSample_t sample = {x, y, pressed, (uint32_t)millis()};
+    _touchLast = sample;
+
+    uint32_t head = _touchHead;
+    if (head - __atomic_load_n(&_touchTail, __ATOMIC_ACQUIRE) >= AMOLED_TOUCH_RING_SIZE) {
+        // The consumer is behind, getPoint still reports the latest state
+        _touchDropped++;
+        return;
+    }
+    _touchRing[head % AMOLED_TOUCH_RING_SIZE] = sample;
+    __atomic_store_n(&_touchHead, head + 1, __ATOMIC_RELEASE);
+}
+
+bool LilyGo_AMOLED::readTouchSample(TouchSample_t *sample)
+{
+    uint32_t tail = _touchTail;
+    if (tail == __atomic_load_n(&_touchHead, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    *sample = _touchRing[tail % AMOLED_TOUCH_RING_SIZE];
+    __atomic_store_n(&_touchTail, tail + 1, __ATOMIC_RELEASE);
+    if (_disableTouch) {
+        sample->pressed = false;
+    }
+    return true;
+}
+
+bool LilyGo_AMOLED::enableTouchInterrupt(bool enable)
+{
+    if (!hasTouch() || boards->touch->irq == BOARD_NONE_PIN) {
+        return false;
+    }
+
+    if (!enable) {
+        if (_touchTask) {
+            detachInterrupt(boards->touch->irq);
+            _touchStop = true;
+            xSemaphoreGive(_touchSemaphore);
+            while (_touchTask) {
+                delay(1);
+            }
+        }
+        return true;
+    }
+
+    if (_touchTask) {
+        return true;
+    }
+    if (!_touchSemaphore) {
+        _touchSemaphore = xSemaphoreCreateBinary();
+        if (!_touchSemaphore) {
+            log_e("Failed to create touch semaphore!");
+            return false;
+        }
+    }
+
+    _touchStop = false;
+    _touchHead = _touchTail = 0;
+    memset(&_touchLast, 0, sizeof(_touchLast));
+    if (xTaskCreate(touchReaderTask, "touch", 3072, this, configMAX_PRIORITIES - 2, &_touchTask) != pdPASS) {
+        log_e("Failed to create touch task!");
+        _touchTask = NULL;
+        return false;
+    }
+    pinMode(boards->touch->irq, INPUT);
+    attachInterruptArg(boards->touch->irq, touchInterruptHandler, this, FALLING);
+    // A finger may already be down
+    xSemaphoreGive(_touchSemaphore);
+    return true;
+}
+
+bool LilyGo_AMOLED::isTouchInterruptEnabled()
+{
+    return _touchTask != NULL;
+}
+
+uint32_t LilyGo_AMOLED::getTouchDropCount()
+{
+    return _touchDropped;
+}
+
+bool LilyGo_AMOLED::enableVsync(bool enable)
+{
+    if (!boards || boards->display.te == BOARD_NONE_PIN) {
+        return false;
+    }
+
+    if (!enable) {
+        if (_vsyncEnabled) {
+            detachInterrupt(boards->display.te);
+            _vsyncEnabled = false;
+        }
+        return true;
+    }
+
+    if (_vsyncEnabled) {
+        return true;
+    }
+
+    if (!_teSemaphore) {
+        _teSemaphore = xSemaphoreCreateBinary();
+        if (!_teSemaphore) {
+            log_e("Failed to create TE semaphore!");
+            return false;
+        }
+    }
+
+    // TE output, V-Blanking information only
+    uint8_t mode = 0x00;
+    writeCommand(LCD_CMD_TEON, &mode, 1);
+
+    _teLastUs = 0;
+    _tePeriodUs = 0;
+    _frameLastUs = 0;
+    pinMode(boards->display.te, INPUT);
+    attachInterruptArg(boards->display.te, teInterruptHandler, this, RISING);
+    _vsyncEnabled = true;
+    return true;
+}
+
+bool LilyGo_AMOLED::isVsyncEnabled()
+{
+    return _vsyncEnabled;
+}
+
+bool LilyGo_AMOLED::waitVsync()
+{
+    if (!_vsyncEnabled) {
+        return false;
+    }
+
+    int64_t start = esp_timer_get_time();
+
+    // Drop an edge that was signaled before we started waiting
+    xSemaphoreTake(_teSemaphore, 0);
+    bool res = xSemaphoreTake(_teSemaphore, pdMS_TO_TICKS(VSYNC_TIMEOUT_MS)) == pdTRUE;
+
+    int64_t now = esp_timer_get_time();
+    uint32_t wait = (uint32_t)(now - start);
+    if (!res) {
+        _vsyncStats.timeoutCount++;
+    }
+    _vsyncStats.waitUs = _vsyncStats.waitUs ? (_vsyncStats.waitUs * 7 + wait) / 8 : wait;
+    if (_frameLastUs) {
+        uint32_t interval = (uint32_t)(now - _frameLastUs);
+        _vsyncStats.frameIntervalUs = _vsyncStats.frameIntervalUs ? (_vsyncStats.frameIntervalUs * 7 + interval) / 8 : interval;
+    }
+    _frameLastUs = now;
+    _vsyncStats.frameCount++;
+    return res;
+}
+
+int32_t LilyGo_AMOLED::getScanLine()
+{
+    if (!_vsyncEnabled || !_tePeriodUs || !_scanAlongY) {
+        return -1;
+    }
+    int64_t elapsed = esp_timer_get_time() - _teLastUs;
+    int32_t line = (int32_t)((elapsed % _tePeriodUs) * _height / _tePeriodUs);
+    return _scanReverse ? (_height - 1 - line) : line;
+}
+
+void LilyGo_AMOLED::getInitTrace(DisplayInitTrace_t *trace)
+{
+    if (!trace) {
+        return;
+    }
+    memcpy(trace, &_initTrace, sizeof(DisplayInitTrace_t));
+}
+
+void LilyGo_AMOLED::getVsyncStats(VsyncStats_t *stats)
+{
+    if (!stats) {
+        return;
+    }
+    memcpy(stats, &_vsyncStats, sizeof(VsyncStats_t));
+    stats->teCount = _teCount;
+    stats->tePeriodUs = _tePeriodUs;
+}
+
+void LilyGo_AMOLED::resetVsyncStats()
+{
+    memset(&_vsyncStats, 0, sizeof(_vsyncStats));
+    _frameLastUs = 0;
 }
 
 float LilyGo_AMOLED::readCoreTemp()
@@ -1076,6 +2198,9 @@ void LilyGo_AMOLED::sleep(bool touchpad_sleep_enable)
 {
     assert(boards);
 
+    // The reader task must not talk to the controller while it goes to sleep
+    enableTouchInterrupt(false);
+
     //Wire amoled to sleep mode
     lcd_cmd_t t = {LCD_CMD_SLPIN, {0x00}, 1}; //Sleep in
     writeCommand(t.addr, t.param, t.len);
@@ -1221,6 +2346,8 @@ void LilyGo_AMOLED::setRotation(uint8_t rotation)
             break;
         }
         writeCommand(LCD_CMD_MADCTL, &data, 1);
+        _scanAlongY = !(data & RM67162_MADCTL_MV);
+        _scanReverse = data & RM67162_MADCTL_MY;
     } else if (boards == &BOARD_AMOLED_241) {
         switch (_rotation) {
         case 1:
@@ -1273,6 +2400,8 @@ void LilyGo_AMOLED::setRotation(uint8_t rotation)
             break;
         }
         writeCommand(LCD_CMD_MADCTL, &data, 1);
+        _scanAlongY = !(data & RM690B0_MADCTL_MV);
+        _scanReverse = data & RM690B0_MADCTL_MY;
     } else {
         log_e("The screen you are currently using does not support screen rotation!!!");
     }
@@ -19,6 +19,8 @@
 #endif
 
 #include <driver/spi_master.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
 #include <SPI.h>
 #include "XPowersLib.h"
 #include "initSequence.h"
@@ -30,6 +32,7 @@
 #include <SD.h>
 #include <sys/cdefs.h>
 #include "LilyGo_Display.h"
+#include "DmaRing.h"
 #if ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5,0,0)
 #include <driver/temp_sensor.h>
 #else
@@ -56,6 +59,37 @@
 #define BOARD_PIXELS_PIN    (18)        //only 1.47 inch
 #define BOARD_PIXELS_NUM    (1)
 #define DEFAULT_SCK_SPEED   (30 * 1000 * 1000)
+// Collect display pipeline statistics, see getPerfStats(). Off by default, no code is generated
+#ifndef AMOLED_PERF_STATS
+#define AMOLED_PERF_STATS       (0)
+#endif
+#ifndef AMOLED_FILL_BUF_SIZE
+#define AMOLED_FILL_BUF_SIZE    (2048)  //Pixels in the internal DMA pattern buffer used by fills
+#endif
+#ifndef AMOLED_FILL_MIN_RUN
+#define AMOLED_FILL_MIN_RUN     (512)   //Shortest run of one color sent from the pattern buffer
+#endif
+#ifndef AMOLED_TOUCH_RING_SIZE
+#define AMOLED_TOUCH_RING_SIZE  (16)    //Touch samples buffered between the reader task and the consumer
+#endif
+#ifndef AMOLED_TOUCH_ACTIVE_MS
+#define AMOLED_TOUCH_ACTIVE_MS  (10)    //Sampling period while a finger is down
+#endif
+#ifndef AMOLED_STAGE_SIZE
+#define AMOLED_STAGE_SIZE       (4096)  //Pixels in each of the two internal buffers used by setSwapBytes
+#endif
+
+/*
+* Reset and init timing of a panel. Values are shortened from the vendor
+* sequence only where the controller datasheet gives the minimum.
+* */
+typedef struct __DisplayTiming {
+    uint16_t powerSettleMs;     // RESX held high after the panel is powered
+    uint16_t resetPulseMs;      // RESX low
+    uint16_t resetWaitMs;       // After RESX goes high, on a power-on reset
+    uint16_t resetAwakeWaitMs;  // After RESX goes high, when the controller may have been left awake
+    uint8_t initPasses;         // Number of times the init sequence is sent
+} DisplayTiming_t;
 
 typedef struct __DisplayConfigure {
     int d0;
@@ -70,14 +104,45 @@ typedef struct __DisplayConfigure {
     uint8_t cmdBit;
     uint8_t addBit;
     int  freq;
-    lcd_cmd_t *initSequence;
-    uint32_t initSize;
+    const uint8_t *initSequence;
+    const DisplayTiming_t *timing;
     uint16_t width;
     uint16_t height;
     uint32_t frameBufferSize;
     bool fullRefresh;
 } DisplayConfigure_t;
 
+typedef struct __VsyncStats {
+    uint32_t teCount;           // Number of TE edges received
+    uint32_t tePeriodUs;        // Measured panel refresh period
+    uint32_t frameCount;        // Number of flushes started on a TE edge
+    uint32_t frameIntervalUs;   // Average interval between two flush starts
+    uint32_t waitUs;            // Average time spent waiting for the TE edge
+    uint32_t splitCount;        // Areas pushed in two parts around the scan line
+    uint32_t timeoutCount;      // TE edge not received in time
+} VsyncStats_t;
+
+typedef struct __DisplayInitTrace {
+    uint32_t resetUs;           // Reset pulse and the wait for the controller
+    uint32_t busUs;             // SPI bus and device setup
+    uint32_t sequenceUs;        // Init sequence, delays included
+    uint32_t commands;          // Number of commands sent
+} DisplayInitTrace_t;
+
+typedef struct __DisplayPerfStats {
+    uint32_t elapsedUs;         // Time since the statistics were reset
+    uint32_t flushCount;        // Areas pushed with pushColors/pushColorsDMA
+    uint64_t pixelCount;        // Pixels sent, fills included
+    uint32_t transactionCount;  // SPI transactions, commands included
+    uint32_t pollingUs;         // Blocked in polling transfers
+    uint32_t dmaWaitUs;         // Blocked waiting for queued transfers
+    uint32_t rotateUs;          // Frame buffer rotation, 1.47 inch only
+    uint32_t flushUs;           // Flush start to transfer done, summed
+    float throughputMBs;        // Pixel bytes sent per second of flushUs
+    float busMBs;               // Limit of the bus at the configured clock
+    float flushRate;            // Flushes per second
+} DisplayPerfStats_t;
+
 typedef struct __BoardTouchPins {
     int sda;
     int scl;
@@ -119,6 +184,15 @@ typedef struct __BoardsConfigure {
 } BoardsConfigure_t;
 
 
+// No datasheet for SH8501 and RM690B0, the vendor timing is kept
+static const DisplayTiming_t SH8501_TIMING = {200, 300, 200, 200, 2};
+static const DisplayTiming_t RM690B0_TIMING = {200, 300, 200, 200, 2};
+// RM67162 datasheet 7.6.3 Reset Timing: tRESW 10us min, tREST 5ms when reset in
+// sleep in mode, 120ms in sleep out mode. The second pass is the vendor's workaround
+// for panels that failed to initialize, not a datasheet timing, so it stays until
+// one pass is verified on hardware. AMOLED_INIT_PASSES=1 opts into the faster boot
+static const DisplayTiming_t RM67162_TIMING = {10, 1, 5, 120, 2};
+
 // LILYGO 1.47 Inch AMOLED(SH8501) S3R8
 // https://www.lilygo.cc/products/t-display-amoled
 static const DisplayConfigure_t SH8501_AMOLED  = {
@@ -134,8 +208,8 @@ static const DisplayConfigure_t SH8501_AMOLED  = {
     8,//command bit
     24,//address bit
     30000000,
-    (lcd_cmd_t *)sh8501_cmd,
-    SH8501_INIT_SEQUENCE_LENGTH,
+    sh8501_cmd,
+    &SH8501_TIMING,
     SH8501_WIDTH, //width
     SH8501_HEIGHT, //height
     SH8501_WIDTH *SH8501_HEIGHT * sizeof(uint16_t), //frameBufferSize
@@ -167,8 +241,8 @@ static const DisplayConfigure_t RM67162_AMOLED  = {
     8, //command bit
     24,//address bit
     75000000,
-    (lcd_cmd_t *)rm67162_cmd,
-    RM67162_INIT_SEQUENCE_LENGTH,
+    rm67162_cmd,
+    &RM67162_TIMING,
     RM67162_WIDTH,//width
     RM67162_HEIGHT,//height
     0,//frameBufferSize
@@ -190,8 +264,8 @@ static const DisplayConfigure_t RM67162_AMOLED_SPI  = {
     8, //command bit
     24,//address bit
     40000000,
-    (lcd_cmd_t *)rm67162_spi_cmd,
-    RM67162_INIT_SPI_SEQUENCE_LENGTH,
+    rm67162_spi_cmd,
+    &RM67162_TIMING,
     RM67162_WIDTH,//width
     RM67162_HEIGHT,//height
     0,//frameBufferSize
@@ -214,8 +288,8 @@ static const DisplayConfigure_t RM690B0_AMOLED  = {
     8, //command bit
     24,//address bit
     36000000,
-    (lcd_cmd_t *)rm690b0_cmd,
-    RM690B0_INIT_SEQUENCE_LENGTH,
+    rm690b0_cmd,
+    &RM690B0_TIMING,
     RM690B0_WIDTH,//width
     RM690B0_HEIGHT,//height
     0,//frameBufferSize
@@ -317,8 +391,20 @@ public:
 
     ~LilyGo_AMOLED();
 
-    // Automatically identify hardware
-    bool begin();
+    /**
+     * @brief  Automatically identify hardware
+     * @note   The detected model is kept in RTC memory, after a deep sleep wake up or
+     *         a software reset the I2C probing and device scans are skipped.
+     * @param  reprobe: true ignore the cached model and probe the I2C buses again
+     * @retval Returns true if successful, otherwise false
+     */
+    bool begin(bool reprobe = false);
+
+    // Forget the cached board model, the next begin() probes again
+    void clearBoardCache();
+
+    // Returns true if the last begin() used the cached board model
+    bool isBoardCached();
 
     bool beginAutomatic() __attribute__((deprecated("please use begin instead")));
 
@@ -355,6 +441,107 @@ public:
     void pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data);
     void pushColorsDMA(uint16_t *data, uint32_t len);
 
+    /**
+     * @brief  Queue the address window and the pixel stream as one transaction chain
+     * @note   The window setup is sent without polling and RAMWR is carried by the first pixel chunk
+     */
+    void pushColorsDMA(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data) override;
+
+    // Send one RGB565 color len times, use setAddrWindow() first
+    void pushRepeat(uint16_t color, uint32_t len) override;
+
+    /**
+     * @brief  Fill a rectangle with one RGB565 color
+     * @note   QSPI boards stream the color from a small internal DMA buffer,
+     *         no full size pixel buffer is needed
+     */
+    void fillRect(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t color) override;
+
+    /**
+     * @brief  Look for long runs of one color in the pushed areas
+     * @note   Runs of at least AMOLED_FILL_MIN_RUN pixels are sent from the fill buffer,
+     *         only the remaining pixels are read from the source by the DMA. QSPI boards only.
+     * @param  enable: true enable the scan , false disable
+     * @retval Returns false if the board does not support it
+     */
+    bool enableFillScan(bool enable = true);
+
+    /**
+     * @brief  Take native RGB565 pixels and swap the bytes while sending
+     * @note   QSPI boards swap each chunk into one of two internal DMA buffers while
+     *         the previous chunk is on the bus, this replaces the copy the SPI driver
+     *         does for PSRAM buffers anyway. The SPI board swaps in the SPI peripheral.
+     * @param  swap: true pixels are native, false pixels are already in bus byte order
+     * @retval Returns false if the staging buffers cannot be allocated
+     */
+    bool setSwapBytes(bool swap) override;
+
+    /**
+     * @brief  Make pushColorsDMA return as soon as all chunks are queued
+     * @note   The callback is called from the SPI interrupt after the last chunk
+     *         has been sent, only QSPI boards support this.
+     * @param  cb: Callback invoked when the transfer is complete, NULL restores blocking mode
+     * @param  user_data: Argument passed to the callback
+     * @retval Returns true if the asynchronous mode is available
+     */
+    bool setFlushReadyCallback(void (*cb)(void *user_data), void *user_data) override;
+
+    // Wait for all queued DMA transactions to complete
+    void waitDMA() override;
+
+    /**
+     * @brief  Synchronize the flush with the panel TE (tearing effect) signal
+     * @note   When enabled, areas pushed with pushColors(x, y, w, h, data) are split
+     *         around the estimated scan line and the part already scanned is sent first.
+     * @param  enable: true enable TE synchronization , false disable
+     * @retval Returns false if the board has no TE pin
+     */
+    bool enableVsync(bool enable = true);
+    bool isVsyncEnabled();
+
+    /**
+     * @brief  Wait for the next TE edge
+     * @retval Returns true if the edge arrived in time, false if vsync is disabled or timed out
+     */
+    bool waitVsync() override;
+
+    // Estimated line the panel is scanning, in logical coordinates, -1 if unknown
+    int32_t getScanLine();
+
+    void getVsyncStats(VsyncStats_t *stats);
+    void resetVsyncStats();
+
+    // Time spent in each phase of the display initialization
+    void getInitTrace(DisplayInitTrace_t *trace);
+
+    /**
+     * @brief  Only send the parts of a frame that changed since the last flush
+     * @note   Boards that rotate through a frame buffer (1.47 Inch) refresh the whole
+     *         screen on every change. This keeps a shadow copy of the panel in PSRAM
+     *         and sends only the changed rows, trimmed to the changed columns.
+     *         Anything written with setAddrWindow/pushColors(data, len) resets the shadow.
+     * @param  enable: true allocate the shadow buffer , false release it
+     * @retval Returns false if the board has no frame buffer or the allocation failed
+     */
+    bool enableFrameDiff(bool enable = true);
+    bool isFrameDiffEnabled();
+
+    /**
+     * @brief  Read the display pipeline statistics
+     * @note   Requires AMOLED_PERF_STATS=1 in the build flags, otherwise only
+     *         transactionCount and busMBs are filled in
+     * @retval Returns false if the statistics are compiled out
+     */
+    bool getPerfStats(DisplayPerfStats_t *stats);
+    void resetPerfStats();
+
+    // Print the statistics, vsync and init timing in a few lines
+    void dumpPerfStats(Stream &stream = Serial);
+
+    // Number of SPI transactions issued to the display, including commands
+    uint32_t getTransactionCount();
+    void resetTransactionCount();
+
     /**
      * @brief   Hang on SD card
      * @note   If the specified Pin is not passed in, the default Pin will be used as the SPI
@@ -378,6 +565,28 @@ public:
     void disableTouch();
     void enableTouch();
 
+    /**
+     * @brief  Read the touch controller from a task woken by the touch IRQ
+     * @note   Nothing is read over I2C while no finger is down. While touched the
+     *         controller is sampled every AMOLED_TOUCH_ACTIVE_MS, the samples are
+     *         buffered for readTouchSample() and getPoint() returns the latest one.
+     *         The home button callback is then called from the reader task.
+     * @param  enable: true start the reader task , false stop it
+     * @retval Returns false if the board has no touch IRQ or the task cannot be created
+     */
+    bool enableTouchInterrupt(bool enable = true);
+    bool isTouchInterruptEnabled();
+
+    /**
+     * @brief  Take the oldest buffered touch sample
+     * @note   Only one task may consume the samples
+     * @retval Returns false if no sample is waiting
+     */
+    bool readTouchSample(TouchSample_t *sample) override;
+
+    // Samples lost because the buffer was full
+    uint32_t getTouchDropCount();
+
     // override
     uint8_t getPoint(int16_t *x_array, int16_t *y_array, uint8_t get_point = 1) override;
     bool isPressed() override;
@@ -421,12 +630,80 @@ private:
     };
 
     bool initBUS(DriverBusType type = QSPI_DRIVER);
+    uint8_t probeDevices();
+    bool beginBoard(uint8_t id, bool touch);
+    void releaseBoard();
     bool initPMU();
     void inline setCS();
     void inline clrCS();
     void writeCommand(uint32_t cmd, uint8_t *pdat, uint32_t length);
+    static void dmaFlushDone(void *arg);
+    spi_transaction_ext_t *acquireSlot(uint8_t flags, uint8_t depth = AMOLED_DMA_QUEUE_SIZE);
+    void queueSlot(spi_transaction_ext_t *t);
+    void queueCommand(uint32_t cmd, const uint8_t *pdat, uint32_t length);
+    void queueWindow(uint16_t xs, uint16_t ys, uint16_t xe, uint16_t ye);
+    uint32_t writeInitSequence(const uint8_t *seq);
+    void queuePixels(uint16_t *data, uint32_t len, bool notify);
+    void queueRun(const uint16_t *data, uint32_t len, bool repeat, bool first, bool last, bool notify);
+    void queueData(uint16_t *data, uint32_t len, bool notify);
+    bool setFillPattern(uint16_t value);
+    uint16_t *rotateToFrameBuffer(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data);
+    static void teInterruptHandler(void *arg);
+    static void touchInterruptHandler(void *arg);
+    static void touchReaderTask(void *arg);
+    uint8_t readTouchPoint(int16_t *x, int16_t *y);
+    void pushTouchSample(int16_t x, int16_t y, bool pressed);
+    void pushSplit(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data);
+    void pushArea(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data);
+    void queueArea(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data, bool notify);
+    void queueFrameDiff(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, bool notify);
+    void queueBand(uint16_t x, uint16_t y, uint16_t width, uint16_t top, uint16_t bottom,
+                   uint16_t left, uint16_t right, bool notify);
     uint16_t *pBuffer;
+    uint16_t *_shadowBuffer;
+    bool _shadowValid;
+    uint16_t *_fillBuffer;
+    uint16_t _fillValue;
+    bool _fillValid;
+    bool _fillScan;
+    uint16_t *_stageBuffer;
+    uint8_t _stageIndex;
     spi_device_handle_t spi;
+    DmaRing_t _dma;
+    uint32_t _transCount;
+    void (*_flushReadyCb)(void *user_data);
+    void *_flushReadyData;
+
+    bool _vsyncEnabled;
+    bool _scanAlongY;
+    bool _scanReverse;
+    SemaphoreHandle_t _teSemaphore;
+    volatile int64_t _teLastUs;
+    volatile uint32_t _tePeriodUs;
+    volatile uint32_t _teCount;
+    int64_t _frameLastUs;
+    VsyncStats_t _vsyncStats;
+    DisplayInitTrace_t _initTrace;
+    TaskHandle_t _touchTask;
+    SemaphoreHandle_t _touchSemaphore;
+    volatile bool _touchStop;
+    TouchSample_t _touchRing[AMOLED_TOUCH_RING_SIZE];
+    volatile uint32_t _touchHead;       //Written by the reader task only
+    volatile uint32_t _touchTail;       //Written by the consumer only
+    volatile uint32_t _touchDropped;
+    TouchSample_t _touchLast;
+#if AMOLED_PERF_STATS
+    struct PerfCounters {
+        int64_t resetUs;
+        int64_t flushStartUs;
+        uint32_t flushCount;
+        uint64_t pixelCount;
+        uint32_t pollingUs;
+        uint32_t dmaWaitUs;
+        uint32_t rotateUs;
+        volatile uint32_t flushUs;
+    } _perf;
+#endif
     uint8_t _brightness;
     const BoardsConfigure_t *boards;
     bool _touchOnline;
@@ -439,6 +716,7 @@ private:
     bool  _hasRTC;
 
     bool _disableTouch;
+    bool _boardCached;
 
     SPIClass *spiDev;
 };
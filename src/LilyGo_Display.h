@@ -9,6 +9,14 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdlib.h>
+
+typedef struct __TouchSample {
+    int16_t x;
+    int16_t y;
+    bool pressed;
+    uint32_t timestamp;         //millis() when the controller was read
+} TouchSample_t;
 
 // enum DispRotation {
 //     DISP_VERTICAL,      // vertical
@@ -25,6 +33,42 @@ public:
     virtual void pushColors(uint16_t *data, uint32_t len) = 0;
     virtual void pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t *data) = 0;
     virtual void pushColorsDMA(uint16_t *data, uint32_t len) = 0;
+    virtual void pushColorsDMA(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t *data)
+    {
+        setAddrWindow(x, y, x + width - 1, y + height - 1);
+        pushColorsDMA(data, width * height);
+    }
+
+    // Send one RGB565 color len times, use setAddrWindow() first
+    virtual void pushRepeat(uint16_t color, uint32_t len)
+    {
+        uint16_t *buffer = (uint16_t *)malloc(len * sizeof(uint16_t));
+        if (!buffer) {
+            return;
+        }
+        // pushColors takes the pixels in bus byte order unless the driver swaps them
+        uint16_t value = _swapBytes ? color : (uint16_t)((color << 8) | (color >> 8));
+        for (uint32_t i = 0; i < len; i++) {
+            buffer[i] = value;
+        }
+        pushColors(buffer, len);
+        free(buffer);
+    }
+
+    // Fill a rectangle with one RGB565 color
+    virtual void fillRect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t color)
+    {
+        setAddrWindow(x, y, x + width - 1, y + height - 1);
+        pushRepeat(color, (uint32_t)width * height);
+    }
+
+    // Let the driver swap the RGB565 bytes while sending, pushColors then takes
+    // native pixels. Returns false if the caller still has to swap them itself
+    virtual bool setSwapBytes(bool swap)
+    {
+        return false;
+    }
+
     virtual uint16_t  width() = 0;
     virtual uint16_t  height() = 0;
 
@@ -33,8 +77,28 @@ public:
 
     virtual bool needFullRefresh() = 0;
 
+    // Buffered touch samples, drivers without a touch reader keep the default
+    virtual bool readTouchSample(TouchSample_t *sample)
+    {
+        return false;
+    }
+
+    // Asynchronous flush support, drivers without a DMA queue keep the default
+    virtual bool setFlushReadyCallback(void (*cb)(void *user_data), void *user_data)
+    {
+        return false;
+    }
+    virtual void waitDMA() {};
+
+    // Tearing effect synchronization, drivers without a TE pin keep the default
+    virtual bool waitVsync()
+    {
+        return false;
+    }
+
 protected:
     uint16_t _offset_x = 0;
     uint16_t _offset_y = 0;
     uint8_t _rotation;
+    bool _swapBytes = false;
 };
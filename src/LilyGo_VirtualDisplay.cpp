@@ -0,0 +1,295 @@
+/**
+ * @file      LilyGo_VirtualDisplay.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2025  Shenzhen Xin Yuan Electronic Technology Co., Ltd
+ * @date      2025-03-18
+ *
+ */
+#include "LilyGo_VirtualDisplay.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Clocks spent on CASET, RASET and RAMWR before the pixels of a window.
+// QSPI sends 8 bit command + 24 bit address on one line, plus 4 parameter bytes
+#define QSPI_WINDOW_CLOCKS      (2 * (32 + 32) + 32)
+// SPI sends 3 command bytes and 8 parameter bytes
+#define SPI_WINDOW_CLOCKS       ((3 + 8) * 8)
+
+LilyGo_VirtualDisplay::LilyGo_VirtualDisplay(const VirtualDisplayConfigure_t &config) :
+    _config(&config), _frame(NULL), _touchX(0), _touchY(0), _touched(false), _logCount(0)
+{
+    _width = config.width;
+    _height = config.height;
+    _offset_x = config.offset_x;
+    _offset_y = config.offset_y;
+    _xs = _ys = _xe = _ye = 0;
+    _cx = _cy = 0;
+    memset(&_stats, 0, sizeof(_stats));
+    memset(_log, 0, sizeof(_log));
+}
+
+LilyGo_VirtualDisplay::~LilyGo_VirtualDisplay()
+{
+    end();
+}
+
+bool LilyGo_VirtualDisplay::begin()
+{
+    if (_frame) {
+        return true;
+    }
+    _frame = (uint16_t *)calloc((uint32_t)_config->width * _config->height, sizeof(uint16_t));
+    return _frame != NULL;
+}
+
+void LilyGo_VirtualDisplay::end()
+{
+    if (_frame) {
+        free(_frame);
+        _frame = NULL;
+    }
+}
+
+void LilyGo_VirtualDisplay::setRotation(uint8_t rotation)
+{
+    if (!_config->rotation) {
+        return;
+    }
+    _rotation = rotation % 4;
+    // The frame memory keeps its content, like the panel GRAM does
+    if (_rotation & 1) {
+        _width = _config->height;
+        _height = _config->width;
+        _offset_x = _config->offset_y;
+        _offset_y = _config->offset_x;
+    } else {
+        _width = _config->width;
+        _height = _config->height;
+        _offset_x = _config->offset_x;
+        _offset_y = _config->offset_y;
+    }
+}
+
+uint8_t LilyGo_VirtualDisplay::getRotation()
+{
+    return _rotation;
+}
+
+void LilyGo_VirtualDisplay::setAddrWindow(uint16_t xs, uint16_t ys, uint16_t xe, uint16_t ye)
+{
+    if (xs > xe || ys > ye || xe >= _width || ye >= _height) {
+        _stats.boundsErrors++;
+    }
+    if (_config->evenAlign && ((xs & 1) || (ys & 1) || !(xe & 1) || !(ye & 1))) {
+        _stats.alignErrors++;
+    }
+    _xs = xs;
+    _ys = ys;
+    _xe = xe < _width ? xe : _width - 1;
+    _ye = ye < _height ? ye : _height - 1;
+    _cx = _xs;
+    _cy = _ys;
+}
+
+void LilyGo_VirtualDisplay::pushColors(uint16_t *data, uint32_t len)
+{
+    writePixels(data, len);
+    record(_xs, _ys, _xe, _ye, len);
+}
+
+void LilyGo_VirtualDisplay::pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t *data)
+{
+    if (_config->fullRefresh && (x || y || width != _width || height != _height)) {
+        _stats.fullRefreshErrors++;
+    }
+    setAddrWindow(x, y, x + width - 1, y + height - 1);
+    pushColors(data, (uint32_t)width * height);
+}
+
+void LilyGo_VirtualDisplay::pushColorsDMA(uint16_t *data, uint32_t len)
+{
+    pushColors(data, len);
+}
+
+void LilyGo_VirtualDisplay::pushColorsDMA(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t *data)
+{
+    pushColors(x, y, width, height, data);
+}
+
+uint16_t LilyGo_VirtualDisplay::width()
+{
+    return _width;
+}
+
+uint16_t LilyGo_VirtualDisplay::height()
+{
+    return _height;
+}
+
+uint8_t LilyGo_VirtualDisplay::getPoint(int16_t *x, int16_t *y, uint8_t get_point)
+{
+    if (!_touched || !get_point) {
+        return 0;
+    }
+    *x = _touchX;
+    *y = _touchY;
+    return 1;
+}
+
+bool LilyGo_VirtualDisplay::hasTouch()
+{
+    return true;
+}
+
+bool LilyGo_VirtualDisplay::needFullRefresh()
+{
+    return _config->fullRefresh;
+}
+
+bool LilyGo_VirtualDisplay::setSwapBytes(bool swap)
+{
+    _swapBytes = swap;
+    return true;
+}
+
+void LilyGo_VirtualDisplay::setTouch(int16_t x, int16_t y, bool pressed)
+{
+    _touchX = x;
+    _touchY = y;
+    _touched = pressed;
+}
+
+const VirtualDisplayConfigure_t *LilyGo_VirtualDisplay::getConfigure()
+{
+    return _config;
+}
+
+const uint16_t *LilyGo_VirtualDisplay::getFrame()
+{
+    return _frame;
+}
+
+uint32_t LilyGo_VirtualDisplay::getFrameHash()
+{
+    uint32_t hash = 2166136261UL;
+    if (!_frame) {
+        return hash;
+    }
+    const uint8_t *p = (const uint8_t *)_frame;
+    uint32_t len = (uint32_t)_width * _height * sizeof(uint16_t);
+    while (len--) {
+        hash ^= *p++;
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+bool LilyGo_VirtualDisplay::savePPM(const char *path)
+{
+    if (!_frame) {
+        return false;
+    }
+    FILE *fp = fopen(path, "wb");
+    if (!fp) {
+        return false;
+    }
+    fprintf(fp, "P6\n%u %u\n255\n", _width, _height);
+    uint8_t rgb[3];
+    uint32_t len = (uint32_t)_width * _height;
+    for (uint32_t i = 0; i < len; i++) {
+        uint16_t c = (uint16_t)((_frame[i] << 8) | (_frame[i] >> 8));
+        rgb[0] = ((c >> 11) & 0x1F) * 255 / 31;
+        rgb[1] = ((c >> 5) & 0x3F) * 255 / 63;
+        rgb[2] = (c & 0x1F) * 255 / 31;
+        if (fwrite(rgb, 1, sizeof(rgb), fp) != sizeof(rgb)) {
+            fclose(fp);
+            return false;
+        }
+    }
+    fclose(fp);
+    return true;
+}
+
+void LilyGo_VirtualDisplay::getStats(VirtualDisplayStats_t *stats)
+{
+    if (!stats) {
+        return;
+    }
+    memcpy(stats, &_stats, sizeof(VirtualDisplayStats_t));
+}
+
+void LilyGo_VirtualDisplay::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+    _logCount = 0;
+}
+
+bool LilyGo_VirtualDisplay::getFlushRecord(uint32_t index, VirtualFlushRecord_t *record)
+{
+    uint32_t available = _logCount < VIRTUAL_DISPLAY_LOG_SIZE ? _logCount : VIRTUAL_DISPLAY_LOG_SIZE;
+    if (!record || index >= available) {
+        return false;
+    }
+    memcpy(record, &_log[(_logCount - 1 - index) % VIRTUAL_DISPLAY_LOG_SIZE], sizeof(VirtualFlushRecord_t));
+    return true;
+}
+
+void LilyGo_VirtualDisplay::dump(FILE *out, uint32_t records)
+{
+    fprintf(out, "%s %ux%u rotation:%u\n", _config->name, _width, _height, _rotation);
+    fprintf(out, "flush:%lu bytes:%llu bus:%lluus\n", (unsigned long)_stats.flushCount,
+            (unsigned long long)_stats.totalBytes, (unsigned long long)_stats.totalBusUs);
+    fprintf(out, "errors bounds:%lu align:%lu fullRefresh:%lu\n", (unsigned long)_stats.boundsErrors,
+            (unsigned long)_stats.alignErrors, (unsigned long)_stats.fullRefreshErrors);
+    VirtualFlushRecord_t r;
+    for (uint32_t i = 0; i < records && getFlushRecord(i, &r); i++) {
+        fprintf(out, "#%lu x:%u y:%u w:%u h:%u bytes:%lu bus:%luus\n", (unsigned long)r.seq,
+                r.x, r.y, r.width, r.height, (unsigned long)r.bytes, (unsigned long)r.busUs);
+    }
+}
+
+void LilyGo_VirtualDisplay::writePixels(const uint16_t *data, uint32_t len)
+{
+    if (!_frame) {
+        return;
+    }
+    // Fill the window row by row and wrap like the panel does
+    while (len--) {
+        if (_cx < _width && _cy < _height) {
+            uint16_t c = *data;
+            _frame[(uint32_t)_cy * _width + _cx] = _swapBytes ? (uint16_t)((c << 8) | (c >> 8)) : c;
+        }
+        data++;
+        if (++_cx > _xe) {
+            _cx = _xs;
+            if (++_cy > _ye) {
+                _cy = _ys;
+            }
+        }
+    }
+}
+
+void LilyGo_VirtualDisplay::record(uint16_t xs, uint16_t ys, uint16_t xe, uint16_t ye, uint32_t len)
+{
+    VirtualFlushRecord_t *r = &_log[_logCount % VIRTUAL_DISPLAY_LOG_SIZE];
+    r->seq = _stats.flushCount;
+    r->x = xs;
+    r->y = ys;
+    r->width = xe - xs + 1;
+    r->height = ye - ys + 1;
+    r->bytes = len * sizeof(uint16_t);
+    r->busUs = busTime(r->bytes);
+    _logCount++;
+
+    _stats.flushCount++;
+    _stats.totalBytes += r->bytes;
+    _stats.totalBusUs += r->busUs;
+}
+
+uint32_t LilyGo_VirtualDisplay::busTime(uint32_t bytes)
+{
+    uint64_t clocks = (uint64_t)bytes * 8 / _config->lanes;
+    clocks += _config->lanes == 4 ? QSPI_WINDOW_CLOCKS : SPI_WINDOW_CLOCKS;
+    return (uint32_t)(clocks * 1000000ULL / _config->freq);
+}
@@ -0,0 +1,138 @@
+/**
+ * @file      LilyGo_VirtualDisplay.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2025  Shenzhen Xin Yuan Electronic Technology Co., Ltd
+ * @date      2025-03-18
+ * @note      Memory backed LilyGo_Display for headless rendering.
+ *            It has no Arduino or ESP-IDF dependency, so the lvgl helpers and UI
+ *            code can also be compiled and run on a PC to measure flush cost
+ *            and compare rendered frames.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include "LilyGo_Display.h"
+
+// Number of flush records kept in the ring buffer
+#ifndef VIRTUAL_DISPLAY_LOG_SIZE
+#define VIRTUAL_DISPLAY_LOG_SIZE    (64)
+#endif
+
+typedef struct __VirtualDisplayConfigure {
+    const char *name;
+    uint16_t width;             //Logical width at rotation 0
+    uint16_t height;            //Logical height at rotation 0
+    uint16_t offset_x;          //Panel offset at rotation 0 and 2, swapped at 1 and 3
+    uint16_t offset_y;
+    uint32_t freq;              //Bus clock
+    uint8_t lanes;              //4 = QSPI, 1 = SPI
+    bool fullRefresh;
+    bool rotation;              //Board supports setRotation
+    bool evenAlign;             //Windows must start and end on 2 pixel boundaries
+} VirtualDisplayConfigure_t;
+
+// Same geometry and bus settings as the boards in LilyGo_AMOLED.h
+static const VirtualDisplayConfigure_t VIRTUAL_AMOLED_147 = {
+    "1.47 inch", 368, 194, 0, 0, 30000000, 4, true, false, false
+};
+static const VirtualDisplayConfigure_t VIRTUAL_AMOLED_191 = {
+    "1.91 inch", 536, 240, 0, 0, 75000000, 4, false, true, true
+};
+static const VirtualDisplayConfigure_t VIRTUAL_AMOLED_191_SPI = {
+    "1.91 inch SPI", 536, 240, 0, 0, 40000000, 1, false, true, true
+};
+static const VirtualDisplayConfigure_t VIRTUAL_AMOLED_241 = {
+    "2.41 inch", 600, 450, 0, 16, 36000000, 4, false, true, true
+};
+
+typedef struct __VirtualFlushRecord {
+    uint32_t seq;
+    uint16_t x, y, width, height;
+    uint32_t bytes;
+    uint32_t busUs;             //Modeled transfer time, window setup included
+} VirtualFlushRecord_t;
+
+typedef struct __VirtualDisplayStats {
+    uint32_t flushCount;
+    uint64_t totalBytes;
+    uint64_t totalBusUs;
+    uint32_t boundsErrors;      //Window outside the screen
+    uint32_t alignErrors;       //Window breaks the panel alignment rule
+    uint32_t fullRefreshErrors; //Partial area on a full refresh board
+} VirtualDisplayStats_t;
+
+class LilyGo_VirtualDisplay : public LilyGo_Display
+{
+public:
+    LilyGo_VirtualDisplay(const VirtualDisplayConfigure_t &config = VIRTUAL_AMOLED_191);
+    ~LilyGo_VirtualDisplay();
+
+    // Allocate the frame memory, returns false if out of memory
+    bool begin();
+    void end();
+
+    // override
+    void setRotation(uint8_t rotation) override;
+    uint8_t getRotation() override;
+    void setAddrWindow(uint16_t xs, uint16_t ys, uint16_t xe, uint16_t ye) override;
+    void pushColors(uint16_t *data, uint32_t len) override;
+    void pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t *data) override;
+    void pushColorsDMA(uint16_t *data, uint32_t len) override;
+    void pushColorsDMA(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t *data) override;
+    uint16_t width() override;
+    uint16_t height() override;
+    uint8_t getPoint(int16_t *x, int16_t *y, uint8_t get_point = 1) override;
+    bool hasTouch() override;
+    bool needFullRefresh() override;
+
+    // The frame always holds bus byte order like the panel GRAM,
+    // with swap the pixels are native and get swapped while written
+    bool setSwapBytes(bool swap) override;
+
+    // Simulated touch, reported by getPoint until released
+    void setTouch(int16_t x, int16_t y, bool pressed = true);
+
+    const VirtualDisplayConfigure_t *getConfigure();
+    const uint16_t *getFrame();
+
+    // FNV-1a hash of the visible frame, used to compare against a known good render
+    uint32_t getFrameHash();
+
+    /**
+     * @brief  Write the visible frame as binary PPM (P6)
+     * @param  path: File path, on the device any mounted VFS path
+     * @retval Returns false if the file cannot be written
+     */
+    bool savePPM(const char *path);
+
+    void getStats(VirtualDisplayStats_t *stats);
+    void resetStats();
+
+    /**
+     * @brief  Read a flush record, newest first
+     * @param  index: 0 is the latest flush
+     * @retval Returns false if there is no such record
+     */
+    bool getFlushRecord(uint32_t index, VirtualFlushRecord_t *record);
+
+    // Print the statistics and the latest records
+    void dump(FILE *out = stdout, uint32_t records = 8);
+
+private:
+    void writePixels(const uint16_t *data, uint32_t len);
+    void record(uint16_t xs, uint16_t ys, uint16_t xe, uint16_t ye, uint32_t len);
+    uint32_t busTime(uint32_t bytes);
+
+    const VirtualDisplayConfigure_t *_config;
+    uint16_t *_frame;
+    uint16_t _width, _height;
+    uint16_t _xs, _ys, _xe, _ye;
+    uint16_t _cx, _cy;
+    int16_t _touchX, _touchY;
+    bool _touched;
+    VirtualDisplayStats_t _stats;
+    VirtualFlushRecord_t _log[VIRTUAL_DISPLAY_LOG_SIZE];
+    uint32_t _logCount;
+};
@@ -0,0 +1,208 @@
+/**
+ * @file      PixelKernel.cpp
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2025  Shenzhen Xin Yuan Electronic Technology Co., Ltd
+ * @date      2025-03-18
+ * @note      RGB565 pixel processing kernels used by the display drivers
+ *
+ */
+#include "PixelKernel.h"
+#include <string.h>
+
+#define PIXEL_MIN(a, b)     ((a) < (b) ? (a) : (b))
+
+void pixel_rotate_scalar(const uint16_t *src, uint16_t *dst, uint16_t width, uint16_t height, uint8_t rotation)
+{
+    uint32_t cum = 0;
+    switch (rotation & 3) {
+    case 1:
+        for (uint16_t j = 0; j < width; j++) {
+            for (uint16_t i = 0; i < height; i++) {
+                dst[cum++] = src[width * (height - i - 1) + j];
+            }
+        }
+        break;
+    case 2:
+        for (uint16_t j = 0; j < height; j++) {
+            for (uint16_t i = 0; i < width; i++) {
+                dst[cum++] = src[width * (height - j - 1) + (width - i - 1)];
+            }
+        }
+        break;
+    case 3:
+        for (uint16_t j = 0; j < width; j++) {
+            for (uint16_t i = 0; i < height; i++) {
+                dst[cum++] = src[width * i + (width - j - 1)];
+            }
+        }
+        break;
+    default:
+        memcpy(dst, src, (uint32_t)width * height * sizeof(uint16_t));
+        break;
+    }
+}
+
+/*
+* Transpose one tile. The source is walked with a fixed stride, so for every
+* destination row only PIXEL_ROTATE_TILE cache lines of the source are touched,
+* and they are reused by the following rows of the same tile.
+* Two vertically adjacent source pixels are packed into one 32-bit store.
+* */
+static inline void rotate_tile(const uint16_t *src, uint16_t *dst, int32_t src_step, int32_t pair_step,
+                               uint16_t rows, uint16_t cols, uint16_t dst_stride, int32_t row_step)
+{
+    for (uint16_t r = 0; r < rows; r++) {
+        const uint16_t *s = src + (int32_t)r * row_step;
+        uint16_t *d = dst + (uint32_t)r * dst_stride;
+        uint16_t c = 0;
+        if (!((uintptr_t)d & 3)) {
+            uint32_t *d32 = (uint32_t *)d;
+            for (; c + 1 < cols; c += 2) {
+                *d32++ = (uint32_t)s[0] | ((uint32_t)s[pair_step] << 16);
+                s += src_step;
+            }
+        }
+        for (; c < cols; c++) {
+            d[c] = *s;
+            s += pair_step;
+        }
+    }
+}
+
+void pixel_rotate(const uint16_t *src, uint16_t *dst, uint16_t width, uint16_t height, uint8_t rotation)
+{
+    rotation &= 3;
+
+    if (rotation == 0) {
+        memcpy(dst, src, (uint32_t)width * height * sizeof(uint16_t));
+        return;
+    }
+
+    if (rotation == 2) {
+        // Reversing the buffer is already a sequential access
+        const uint16_t *s = src + (uint32_t)width * height;
+        uint32_t len = (uint32_t)width * height;
+        while (len--) {
+            *dst++ = *--s;
+        }
+        return;
+    }
+
+    // Rotation 1 and 3, the destination is height wide and width high
+    for (uint16_t tr = 0; tr < width; tr += PIXEL_ROTATE_TILE) {
+        uint16_t rows = PIXEL_MIN(PIXEL_ROTATE_TILE, width - tr);
+        for (uint16_t tc = 0; tc < height; tc += PIXEL_ROTATE_TILE) {
+            uint16_t cols = PIXEL_MIN(PIXEL_ROTATE_TILE, height - tc);
+            uint16_t *d = dst + (uint32_t)tr * height + tc;
+            if (rotation == 1) {
+                // dst[r][c] = src[height - 1 - c][r]
+                const uint16_t *s = src + (uint32_t)width * (height - 1 - tc) + tr;
+                rotate_tile(s, d, -2 * (int32_t)width, -(int32_t)width, rows, cols, height, 1);
+            } else {
+                // dst[r][c] = src[c][width - 1 - r]
+                const uint16_t *s = src + (uint32_t)width * tc + (width - 1 - tr);
+                rotate_tile(s, d, 2 * (int32_t)width, width, rows, cols, height, -1);
+            }
+        }
+    }
+}
+
+bool pixel_diff_span(const uint16_t *a, const uint16_t *b, uint32_t len, uint32_t *first, uint32_t *last)
+{
+    uint32_t i = 0;
+    uint32_t j = len;
+    bool words = (((uintptr_t)a ^ (uintptr_t)b) & 3) == 0;
+
+    // Scan forward for the first difference
+    if (words) {
+        if (((uintptr_t)a & 3) && i < len && a[i] == b[i]) {
+            i++;
+        }
+        if (!((uintptr_t)(a + i) & 3)) {
+            while (i + 1 < len && *(const uint32_t *)(a + i) == *(const uint32_t *)(b + i)) {
+                i += 2;
+            }
+        }
+    }
+    while (i < len && a[i] == b[i]) {
+        i++;
+    }
+    if (i == len) {
+        return false;
+    }
+
+    // Scan backward for the last one, a difference at i stops the scan
+    if (words) {
+        if (((uintptr_t)(a + j) & 3) && a[j - 1] == b[j - 1]) {
+            j--;
+        }
+        if (!((uintptr_t)(a + j) & 3)) {
+            while (j >= i + 2 && *(const uint32_t *)(a + j - 2) == *(const uint32_t *)(b + j - 2)) {
+                j -= 2;
+            }
+        }
+    }
+    while (a[j - 1] == b[j - 1]) {
+        j--;
+    }
+
+    *first = i;
+    *last = j - 1;
+    return true;
+}
+
+uint32_t pixel_run_length(const uint16_t *p, uint32_t len)
+{
+    uint16_t c = p[0];
+    uint32_t i = 1;
+
+    if (i < len && ((uintptr_t)(p + i) & 3)) {
+        if (p[i] != c) {
+            return i;
+        }
+        i++;
+    }
+    uint32_t pair = ((uint32_t)c << 16) | c;
+    while (i + 1 < len && *(const uint32_t *)(p + i) == pair) {
+        i += 2;
+    }
+    while (i < len && p[i] == c) {
+        i++;
+    }
+    return i;
+}
+
+void pixel_swap(uint16_t *dst, const uint16_t *src, uint32_t len)
+{
+    if (!(((uintptr_t)dst ^ (uintptr_t)src) & 3)) {
+        if (((uintptr_t)src & 3) && len) {
+            uint16_t v = *src++;
+            *dst++ = (uint16_t)((v << 8) | (v >> 8));
+            len--;
+        }
+        uint32_t *d = (uint32_t *)dst;
+        const uint32_t *s = (const uint32_t *)src;
+        while (len >= 8) {
+            uint32_t v0 = s[0], v1 = s[1], v2 = s[2], v3 = s[3];
+            d[0] = ((v0 & 0x00FF00FF) << 8) | ((v0 >> 8) & 0x00FF00FF);
+            d[1] = ((v1 & 0x00FF00FF) << 8) | ((v1 >> 8) & 0x00FF00FF);
+            d[2] = ((v2 & 0x00FF00FF) << 8) | ((v2 >> 8) & 0x00FF00FF);
+            d[3] = ((v3 & 0x00FF00FF) << 8) | ((v3 >> 8) & 0x00FF00FF);
+            s += 4;
+            d += 4;
+            len -= 8;
+        }
+        while (len >= 2) {
+            uint32_t v = *s++;
+            *d++ = ((v & 0x00FF00FF) << 8) | ((v >> 8) & 0x00FF00FF);
+            len -= 2;
+        }
+        dst = (uint16_t *)d;
+        src = (const uint16_t *)s;
+    }
+    while (len--) {
+        uint16_t v = *src++;
+        *dst++ = (uint16_t)((v << 8) | (v >> 8));
+    }
+}
@@ -0,0 +1,62 @@
+/**
+ * @file      PixelKernel.h
+ * @author    Lewis He (lewishe@outlook.com)
+ * @license   MIT
+ * @copyright Copyright (c) 2025  Shenzhen Xin Yuan Electronic Technology Co., Ltd
+ * @date      2025-03-18
+ * @note      RGB565 pixel processing kernels used by the display drivers
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+
+// Edge length of the square block handled at once by the rotation kernel,
+// 32x32 pixels keep the source and destination tiles (4KB) inside the data cache
+#ifndef PIXEL_ROTATE_TILE
+#define PIXEL_ROTATE_TILE       (32)
+#endif
+
+/**
+ * @brief  Rotate an RGB565 block clockwise
+ * @note   For rotation 1 and 3 the destination is height pixels wide and width pixels high.
+ *         src and dst must not overlap.
+ * @param  src: Source pixels, width x height, row major
+ * @param  dst: Destination pixels
+ * @param  width: Source width in pixels
+ * @param  height: Source height in pixels
+ * @param  rotation: 0 = none, 1 = 90, 2 = 180, 3 = 270 degrees
+ */
+void pixel_rotate(const uint16_t *src, uint16_t *dst, uint16_t width, uint16_t height, uint8_t rotation);
+
+// Reference implementation, one pixel at a time, used to verify pixel_rotate
+void pixel_rotate_scalar(const uint16_t *src, uint16_t *dst, uint16_t width, uint16_t height, uint8_t rotation);
+
+/**
+ * @brief  Find the first and last pixel that differ between two rows
+ * @note   Rows are compared 32 bits at a time when both have the same alignment
+ * @param  a: First row
+ * @param  b: Second row
+ * @param  len: Row length in pixels
+ * @param  first: Index of the first differing pixel
+ * @param  last: Index of the last differing pixel
+ * @retval Returns false if the rows are identical
+ */
+bool pixel_diff_span(const uint16_t *a, const uint16_t *b, uint32_t len, uint32_t *first, uint32_t *last);
+
+/**
+ * @brief  Count how many pixels from the start of a buffer share the first pixel's value
+ * @param  p: Pixels
+ * @param  len: Number of pixels available, at least 1
+ * @retval Length of the run, between 1 and len
+ */
+uint32_t pixel_run_length(const uint16_t *p, uint32_t len);
+
+/**
+ * @brief  Swap the bytes of RGB565 pixels, two pixels per 32-bit word
+ * @note   dst may be equal to src for an in-place swap
+ * @param  dst: Destination pixels
+ * @param  src: Source pixels
+ * @param  len: Number of pixels
+ */
+void pixel_swap(uint16_t *dst, const uint16_t *src, uint32_t len);
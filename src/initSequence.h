@@ -16,16 +16,28 @@ typedef struct {
     uint32_t len;
 } lcd_cmd_t;
 
+/*
+* Init sequences are dense byte streams, each command is stored as
+*   <param count> <command> <params...>
+* A count above LCD_INIT_CMD_MAX is an opcode instead of a command.
+* */
+#define LCD_INIT_CMD_MAX                        0x1F
+#define LCD_INIT_DELAY                          0xFE    //Followed by the delay in milliseconds
+#define LCD_INIT_END                            0xFF
+
+// RM67162 datasheet SLPOUT (11h): wait 5ms before sending the next command
+#ifndef RM67162_SLPOUT_DELAY_MS
+#define RM67162_SLPOUT_DELAY_MS                 5
+#endif
+
 #define AMOLED_DEFAULT_BRIGHTNESS               175
 
-#define SH8501_INIT_SEQUENCE_LENGTH             407
-extern const lcd_cmd_t sh8501_cmd[SH8501_INIT_SEQUENCE_LENGTH];
+extern const uint8_t sh8501_cmd[];
 #define SH8501_WIDTH                            368
 #define SH8501_HEIGHT                           194
 
 
-#define RM67162_INIT_SEQUENCE_LENGTH            12
-extern const lcd_cmd_t rm67162_cmd[RM67162_INIT_SEQUENCE_LENGTH];
+extern const uint8_t rm67162_cmd[];
 #define RM67162_WIDTH                           240
 #define RM67162_HEIGHT                          536
 #define RM67162_MADCTL_MY                       0x80
@@ -36,8 +48,7 @@ extern const lcd_cmd_t rm67162_cmd[RM67162_INIT_SEQUENCE_LENGTH];
 #define RM67162_MADCTL_MH                       0x04
 #define RM67162_MADCTL_BGR                      0x08
 
-#define RM690B0_INIT_SEQUENCE_LENGTH             13
-extern const lcd_cmd_t rm690b0_cmd[RM690B0_INIT_SEQUENCE_LENGTH];
+extern const uint8_t rm690b0_cmd[];
 #define RM690B0_WIDTH                            600
 #define RM690B0_HEIGHT                           450
 #define RM690B0_MADCTL_MY                       0x80
@@ -48,14 +59,12 @@ extern const lcd_cmd_t rm690b0_cmd[RM690B0_INIT_SEQUENCE_LENGTH];
 #define RM690B0_MADCTL_MH                       0x04
 #define RM690B0_MADCTL_BGR                      0x08
 
-#define JD9613_INIT_SEQUENCE_LENGTH             88
-extern const lcd_cmd_t jd9613_cmd[JD9613_INIT_SEQUENCE_LENGTH];
+extern const uint8_t jd9613_cmd[];
 #define JD9613_WIDTH                            294
 #define JD9613_HEIGHT                           126
 
 
-#define RM67162_INIT_SPI_SEQUENCE_LENGTH        18
-extern const lcd_cmd_t rm67162_spi_cmd[RM67162_INIT_SPI_SEQUENCE_LENGTH];
+extern const uint8_t rm67162_spi_cmd[];
 
 
 
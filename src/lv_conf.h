@@ -60,10 +60,14 @@
 #endif
 
 #else       /*LV_MEM_CUSTOM*/
-#define LV_MEM_CUSTOM_INCLUDE <esp32-hal-psram.h>   /*Header for the dynamic memory function*/
-#define LV_MEM_CUSTOM_ALLOC   ps_malloc
-#define LV_MEM_CUSTOM_FREE    free
-#define LV_MEM_CUSTOM_REALLOC ps_realloc
+/*Small blocks from a pool in internal SRAM, large ones from PSRAM, see LV_TieredMem.h.
+ *Use <esp32-hal-psram.h> with ps_malloc, free and ps_realloc to keep everything in PSRAM*/
+#define LV_MEM_CUSTOM_INCLUDE <LV_TieredMem.h>   /*Header for the dynamic memory function*/
+#define LV_MEM_CUSTOM_ALLOC   lv_tiered_malloc
+#define LV_MEM_CUSTOM_FREE    lv_tiered_free
+#define LV_MEM_CUSTOM_REALLOC lv_tiered_realloc
+#define LV_TIERED_SRAM_POOL_SIZE (48U * 1024U)      /*[bytes]*/
+#define LV_TIERED_SRAM_MAX_ALLOC 256                /*Larger blocks go to PSRAM*/
 #endif     /*LV_MEM_CUSTOM*/
 
 /*Number of the intermediate memory buffer used during rendering and other internal processing mechanisms.
@@ -110,7 +114,8 @@
 
 /*Allow buffering some shadow calculation.
 *LV_SHADOW_CACHE_SIZE is the max. shadow size to buffer, where shadow size is `shadow_width + radius`
-*Caching has LV_SHADOW_CACHE_SIZE^2 RAM cost*/
+*Caching has LV_SHADOW_CACHE_SIZE^2 RAM cost
+*Whole shadows of any size are kept in PSRAM by beginLvglShadowCache(), see LV_ShadowCache.h*/
 #define LV_SHADOW_CACHE_SIZE 0
 
 /* Set number of maximally cached circle data.
@@ -140,7 +145,8 @@
  *If only the built-in image formats are used there is no real advantage of caching. (I.e. if no new image decoder is added)
  *With complex image decoders (e.g. PNG or JPG) caching can save the continuous open/decode of images.
  *However the opened images might consume additional RAM.
- *0: to disable caching*/
+ *0: to disable caching
+ *Decoded PNG, SJPG and BMP pixels are kept in PSRAM by beginLvglImageCache(), see LV_ImageCache.h*/
 #define LV_IMG_CACHE_DEF_SIZE 0
 
 /*Number of stops allowed per gradient. Increase this to allow more stops.
@@ -151,8 +157,9 @@
  *When LVGL calculates the gradient "maps" it can save them into a cache to avoid calculating them again.
  *LV_GRAD_CACHE_DEF_SIZE sets the size of this cache in bytes.
  *If the cache is too small the map will be allocated only while it's required for the drawing.
- *0 mean no caching.*/
-#define LV_GRAD_CACHE_DEF_SIZE 0
+ *0 mean no caching.
+ *The cache is allocated with lv_mem_alloc, so it is placed in PSRAM*/
+#define LV_GRAD_CACHE_DEF_SIZE (16U * 1024U)
 
 /*Allow dithering the gradients (to achieve visual smooth color gradients on limited color depth display)
  *LV_DITHER_GRADIENT implies allocating one or two more lines of the object's rendering surface
@@ -0,0 +1,44 @@
+/**
+ * @file      bench_common.h
+ * @brief     Timing helpers shared by the host benchmarks
+ */
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+// Number of timed runs, "--loops N" on the command line overrides the default
+static inline int bench_loops(int argc, char **argv, int loops)
+{
+    for (int i = 1; i + 1 < argc; i++) {
+        if (!strcmp(argv[i], "--loops")) {
+            loops = atoi(argv[i + 1]);
+        }
+    }
+    return loops > 0 ? loops : 1;
+}
+
+// Keeps the compiler from dropping a result nobody reads
+static inline void bench_keep(const void *p)
+{
+    __asm__ __volatile__("" : : "g"(p) : "memory");
+}
+
+// Median time of one call in microseconds, after one warm-up call
+template <typename F>
+static double bench_median_us(int loops, F fn)
+{
+    std::vector<double> t(loops);
+    fn();
+    for (int i = 0; i < loops; i++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        t[i] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+    std::sort(t.begin(), t.end());
+    return t[loops / 2];
+}
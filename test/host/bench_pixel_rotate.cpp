@@ -0,0 +1,44 @@
+/**
+ * @file      bench_pixel_rotate.cpp
+ * @brief     Tiled rotation kernel against the scalar reference, all four orientations
+ * @note      Host numbers only rank the two kernels, the board has a much smaller
+ *            data cache in front of PSRAM, see examples/PixelKernel_Benchmark for it
+ */
+
+#include "PixelKernel.h"
+#include "bench_common.h"
+#include <string.h>
+#include <vector>
+
+typedef void (*rotate_fn)(const uint16_t *, uint16_t *, uint16_t, uint16_t, uint8_t);
+
+int main(int argc, char **argv)
+{
+    // The 1.47 inch frame as rendered and the largest board frame
+    const uint16_t sizes[][2] = {
+        {368, 194},
+        {600, 450},
+    };
+    int loops = bench_loops(argc, argv, 50);
+
+    printf("%-9s %-8s %12s %12s %8s\n", "size", "rotation", "scalar us", "tiled us", "speedup");
+    for (auto &s : sizes) {
+        uint32_t len = (uint32_t)s[0] * s[1];
+        std::vector<uint16_t> src(len), dst(len);
+        for (uint32_t i = 0; i < len; i++) {
+            src[i] = (uint16_t)(i * 2654435761u >> 16);
+        }
+        for (uint8_t r = 0; r < 4; r++) {
+            double us[2];
+            rotate_fn fn[2] = {pixel_rotate_scalar, pixel_rotate};
+            for (int k = 0; k < 2; k++) {
+                us[k] = bench_median_us(loops, [&] {
+                    fn[k](src.data(), dst.data(), s[0], s[1], r);
+                    bench_keep(dst.data());
+                });
+            }
+            printf("%3ux%-5u %-8u %12.1f %12.1f %7.2fx\n", s[0], s[1], r, us[0], us[1], us[0] / us[1]);
+        }
+    }
+    return 0;
+}
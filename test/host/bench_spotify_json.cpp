@@ -0,0 +1,129 @@
+/**
+ * @file      bench_spotify_json.cpp
+ * @brief     Filtered now-playing documents of projects/homeapp/spotify.cpp on the
+ *            sample responses in spotify_payloads, with the old and the current size
+ * @note      "esp32" is the pool the document takes on the board, 16 byte slots and
+ *            the strings it keeps. The host parse itself runs with 64-bit slots, so
+ *            the documents here are sized the same way from JSON_OBJECT_SIZE()
+ */
+
+#include <ArduinoJson.h>
+#include "bench_common.h"
+#include <dirent.h>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+
+// As in spotify.cpp, before and after sizing for the filtered worst case
+#define OLD_JSON_LEN (JSON_OBJECT_SIZE(6) + JSON_ARRAY_SIZE(8) + 768)
+#define SPOTIFY_MAX_ARTISTS 32
+#define SPOTIFY_TEXT_LEN 1024
+#define SPOTIFY_FIELD_NAMES_LEN 64
+#define SPOTIFY_JSON_LEN (JSON_OBJECT_SIZE(8) + JSON_ARRAY_SIZE(SPOTIFY_MAX_ARTISTS) + \
+                          SPOTIFY_FIELD_NAMES_LEN + SPOTIFY_TEXT_LEN)
+
+#define ESP32_SLOT_SIZE     (16)
+
+static StaticJsonDocument<JSON_OBJECT_SIZE(8)> responseFilter;
+static StaticJsonDocument<OLD_JSON_LEN> oldDoc;
+static StaticJsonDocument<SPOTIFY_JSON_LEN> newDoc;
+static StaticJsonDocument<16384> fullDoc;
+
+// Slots and distinct strings of a document, strings are stored once each
+static void countDoc(JsonVariantConst v, size_t *slots, std::set<std::string> *strings)
+{
+    if (v.is<JsonObjectConst>()) {
+        for (JsonPairConst p : v.as<JsonObjectConst>()) {
+            (*slots)++;
+            strings->insert(p.key().c_str());
+            countDoc(p.value(), slots, strings);
+        }
+    } else if (v.is<JsonArrayConst>()) {
+        for (JsonVariantConst e : v.as<JsonArrayConst>()) {
+            (*slots)++;
+            countDoc(e, slots, strings);
+        }
+    } else if (v.is<const char *>()) {
+        strings->insert(v.as<const char *>());
+    }
+}
+
+static size_t esp32Size(JsonVariantConst v)
+{
+    size_t slots = 0;
+    std::set<std::string> strings;
+    countDoc(v, &slots, &strings);
+    size_t size = slots * ESP32_SLOT_SIZE;
+    for (const std::string &s : strings) {
+        size += s.size() + 1;
+    }
+    return size;
+}
+
+// Fields the UI still gets from a document, a NoMemory result keeps the ones before the cut
+static std::string keptFields(JsonObjectConst doc)
+{
+    std::string kept;
+    for (JsonPairConst p : doc) {
+        if (p.value().is<JsonArrayConst>()) {
+            kept += std::string(p.key().c_str()) + "[" + std::to_string(p.value().size()) + "] ";
+        } else if (!p.value().isNull()) {
+            kept += std::string(p.key().c_str()) + " ";
+        }
+    }
+    return kept;
+}
+
+int main(int argc, char **argv)
+{
+    const char *const fields[] = {"isLoggedIn", "success", "isPlaying", "title", "artists", "id", "progress", "duration"};
+    for (const char *field : fields) {
+        responseFilter[field] = true;
+    }
+    int loops = bench_loops(argc, argv, 2000);
+
+    std::set<std::string> names;
+    DIR *dir = opendir(PAYLOAD_DIR);
+    if (!dir) {
+        fprintf(stderr, "%s not found\n", PAYLOAD_DIR);
+        return 1;
+    }
+    while (struct dirent *e = readdir(dir)) {
+        std::string name = e->d_name;
+        if (name.size() > 5 && name.compare(name.size() - 5, 5, ".json") == 0) {
+            names.insert(name);
+        }
+    }
+    closedir(dir);
+
+    printf("esp32 document: old %d bytes, now %d bytes\n",
+           (int)(6 * ESP32_SLOT_SIZE + 8 * ESP32_SLOT_SIZE + 768),
+           (int)((8 + SPOTIFY_MAX_ARTISTS) * ESP32_SLOT_SIZE + SPOTIFY_FIELD_NAMES_LEN + SPOTIFY_TEXT_LEN));
+    printf("%-30s %6s %6s %10s %10s %8s  %s\n", "payload", "raw", "esp32", "old", "now", "parse us", "kept now");
+    for (const std::string &name : names) {
+        std::ifstream in(std::string(PAYLOAD_DIR "/") + name);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        std::string raw = ss.str();
+
+        // Size the filtered document would need with no limit
+        DeserializationError error = deserializeJson(fullDoc, raw, DeserializationOption::Filter(responseFilter));
+        if (error) {
+            fprintf(stderr, "%s: %s\n", name.c_str(), error.c_str());
+            return 1;
+        }
+        size_t need = esp32Size(fullDoc.as<JsonVariantConst>());
+
+        DeserializationError oldError = deserializeJson(oldDoc, raw, DeserializationOption::Filter(responseFilter));
+        DeserializationError newError = deserializeJson(newDoc, raw, DeserializationOption::Filter(responseFilter));
+        std::string kept = keptFields(newDoc.as<JsonObjectConst>());
+        double us = bench_median_us(loops, [&] {
+            deserializeJson(newDoc, raw, DeserializationOption::Filter(responseFilter));
+            bench_keep(&newDoc);
+        });
+        printf("%-30s %6zu %6zu %10s %10s %8.2f  %s\n", name.c_str(), raw.size(), need,
+               oldError.c_str(), newError.c_str(), us, kept.c_str());
+    }
+    return 0;
+}
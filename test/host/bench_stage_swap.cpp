@@ -0,0 +1,94 @@
+/**
+ * @file      bench_stage_swap.cpp
+ * @brief     Cost of folding the byte swap into the staging copy, per board resolution
+ * @note      Same passes as examples/PixelKernel_Benchmark: a scalar swap, pixel_swap
+ *            in place, the plain copy through the staging buffer the SPI driver does
+ *            anyway and that copy with the swap folded in, as setSwapBytes() does
+ */
+
+#include "PixelKernel.h"
+#include "bench_common.h"
+#include <string.h>
+#include <vector>
+
+#define STAGE_SIZE      (4096)
+
+static uint16_t stage_buf[STAGE_SIZE];
+
+static void swap_scalar(uint16_t *p, uint32_t len)
+{
+    while (len--) {
+        *p = (uint16_t)((*p << 8) | (*p >> 8));
+        p++;
+    }
+}
+
+static void stage_copy(const uint16_t *src, uint32_t len)
+{
+    while (len) {
+        uint32_t n = len > STAGE_SIZE ? STAGE_SIZE : len;
+        memcpy(stage_buf, src, n * sizeof(uint16_t));
+        bench_keep(stage_buf);
+        src += n;
+        len -= n;
+    }
+}
+
+static void stage_swap(const uint16_t *src, uint32_t len)
+{
+    while (len) {
+        uint32_t n = len > STAGE_SIZE ? STAGE_SIZE : len;
+        pixel_swap(stage_buf, src, n);
+        bench_keep(stage_buf);
+        src += n;
+        len -= n;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    // Frame sizes of the 1.47, 1.91 and 2.41 inch boards
+    const uint16_t sizes[][2] = {
+        {194, 368},
+        {240, 536},
+        {600, 450},
+    };
+    int loops = bench_loops(argc, argv, 50);
+
+    printf("%-9s %10s %10s %12s %12s %10s\n", "size", "scalar us", "word us", "copy us", "swap us", "extra us");
+    for (auto &s : sizes) {
+        uint32_t len = (uint32_t)s[0] * s[1];
+        std::vector<uint16_t> src(len), ref(len);
+        for (uint32_t i = 0; i < len; i++) {
+            src[i] = (uint16_t)(i * 2654435761u >> 16);
+        }
+
+        // The last staged chunk has to match the scalar swap of the same pixels
+        ref = src;
+        swap_scalar(ref.data(), len);
+        stage_swap(src.data(), len);
+        uint32_t tail = len % STAGE_SIZE ? len % STAGE_SIZE : STAGE_SIZE;
+        if (memcmp(stage_buf, ref.data() + len - tail, tail * sizeof(uint16_t))) {
+            fprintf(stderr, "%ux%u staged swap differs from the scalar swap\n", s[0], s[1]);
+            return 1;
+        }
+
+        double us[4];
+        us[0] = bench_median_us(loops, [&] {
+            swap_scalar(src.data(), len);
+            bench_keep(src.data());
+        });
+        us[1] = bench_median_us(loops, [&] {
+            pixel_swap(src.data(), src.data(), len);
+            bench_keep(src.data());
+        });
+        us[2] = bench_median_us(loops, [&] {
+            stage_copy(src.data(), len);
+        });
+        us[3] = bench_median_us(loops, [&] {
+            stage_swap(src.data(), len);
+        });
+        printf("%3ux%-5u %10.1f %10.1f %12.1f %12.1f %10.1f\n", s[0], s[1], us[0], us[1], us[2], us[3], us[3] - us[2]);
+    }
+    return 0;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file      LilyGo_AMOLED.h
+ * @brief     Host board for the homeapp UI, found before src/LilyGo_AMOLED.h on the include path
+ * @note      The panel is a LilyGo_VirtualDisplay with the 1.91 inch geometry,
+ *            the home button is pressed by the host program
+ */
+#pragma once
+
+#include <Arduino.h>
+#include "LilyGo_VirtualDisplay.h"
+
+class LilyGo_AMOLED : public LilyGo_VirtualDisplay
+{
+public:
+    LilyGo_AMOLED() : LilyGo_VirtualDisplay(VIRTUAL_AMOLED_191), _brightness(0), _homeCb(NULL), _homeArg(NULL) {}
+
+    void setBrightness(uint8_t level)
+    {
+        _brightness = level;
+    }
+
+    uint8_t getBrightness()
+    {
+        return _brightness;
+    }
+
+    void setHomeButtonCallback(void (*cb)(void *arg), void *arg)
+    {
+        _homeCb = cb;
+        _homeArg = arg;
+    }
+
+    void pressHomeButton()
+    {
+        if (_homeCb) {
+            _homeCb(_homeArg);
+        }
+    }
+
+private:
+    uint8_t _brightness;
+    void (*_homeCb)(void *arg);
+    void *_homeArg;
+};
+
+#ifndef LilyGo_Class
+#define LilyGo_Class LilyGo_AMOLED
+#endif
@@ -0,0 +1,292 @@
+/**
+ * @file      homeapp_ui.cpp
+ * @brief     Renders the homeapp UI headless on the virtual display
+ *
+ * initDisplay() and setupUI() of projects/homeapp run unchanged against a
+ * LilyGo_VirtualDisplay with the 1.91 inch geometry, driven by beginLvglHelper.
+ * A fixed list of scenes is played on a virtual clock, after each one the
+ * frame is written as PPM and its hash compared with a reference list.
+ *
+ *   homeapp_ui [--out DIR] [--reference FILE] [--update-reference FILE]
+ *
+ * DIR receives one PPM per scene, frames.txt with the hashes and timings.csv
+ * with the render time, the flushes and the modeled bus time of every scene.
+ */
+
+#include "config.h"
+#include "display.h"
+#include "clock.h"
+#include "cover.h"
+#include "playback.h"
+#include "spotify.h"
+#include <LV_Runtime.h>
+#include <esp_timer.h>
+#include <map>
+#include <string>
+#include <vector>
+
+// The network side of the app is not built, the UI only needs these
+lv_obj_t *cover_art = NULL;
+static int playClicks;
+static int prevClicks;
+static int nextClicks;
+
+void spotify_play_callback(lv_event_t *e)
+{
+    playClicks++;
+}
+
+void spotify_prev_callback(lv_event_t *e)
+{
+    prevClicks++;
+}
+
+void spotify_next_callback(lv_event_t *e)
+{
+    nextClicks++;
+}
+
+#define FRAME_MS    (LV_DISP_DEF_REFR_PERIOD)
+
+struct SceneResult {
+    std::string name;
+    uint32_t hash;
+    uint32_t frames;
+    double renderUs;            // Wall time spent in lv_timer_handler
+    double maxFrameUs;
+    uint32_t flushes;
+    uint64_t pixels;
+    uint64_t bytes;
+    uint64_t busUs;             // Modeled transfer time on the panel bus
+};
+
+static std::string outDir = ".";
+static std::vector<SceneResult> results;
+
+// Run lvgl for ms of virtual time, one refresh period per step
+static void run(SceneResult *r, uint32_t ms)
+{
+    for (uint32_t t = 0; t < ms; t += FRAME_MS) {
+        hostAdvanceMillis(FRAME_MS);
+        int64_t start = esp_timer_get_time();
+        lv_timer_handler();
+        double us = (double)(esp_timer_get_time() - start);
+        r->renderUs += us;
+        r->maxFrameUs = us > r->maxFrameUs ? us : r->maxFrameUs;
+        r->frames++;
+    }
+}
+
+static void scene(const char *name, uint32_t ms, void (*change)())
+{
+    SceneResult r = {};
+    r.name = name;
+    VirtualDisplayStats_t before, after;
+    amoled.getStats(&before);
+    LvHelperStats_t helper;
+    resetLvglHelperStats();
+
+    if (change) {
+        change();
+    }
+    run(&r, ms);
+
+    amoled.getStats(&after);
+    getLvglHelperStats(&helper);
+    r.flushes = after.flushCount - before.flushCount;
+    r.bytes = after.totalBytes - before.totalBytes;
+    r.busUs = after.totalBusUs - before.totalBusUs;
+    r.pixels = helper.pixelCount;
+    r.hash = amoled.getFrameHash();
+    if (after.boundsErrors != before.boundsErrors || after.alignErrors != before.alignErrors) {
+        fprintf(stderr, "%s: flush outside the screen or off the 2 pixel grid\n", name);
+        r.hash = 0;
+    }
+
+    std::string path = outDir + "/" + name + ".ppm";
+    if (!amoled.savePPM(path.c_str())) {
+        fprintf(stderr, "Cannot write %s\n", path.c_str());
+    }
+    results.push_back(r);
+}
+
+static void showClock()
+{
+    struct tm tm = {};
+    tm.tm_year = 2024 - 1900;
+    tm.tm_mon = 3;
+    tm.tm_mday = 16;
+    tm.tm_hour = 9;
+    tm.tm_min = 41;
+    hostSetLocalTime(&tm);
+    hostAdvanceMillis(clockUpdateInterval);
+    updateClock();
+}
+
+static void showMinuteChange()
+{
+    struct tm tm = {};
+    tm.tm_year = 2024 - 1900;
+    tm.tm_mon = 3;
+    tm.tm_mday = 16;
+    tm.tm_hour = 9;
+    tm.tm_min = 42;
+    hostSetLocalTime(&tm);
+    hostAdvanceMillis(clockUpdateInterval);
+    updateClock();
+}
+
+// Same updates the Spotify task posts for a new track
+static void showNowPlaying()
+{
+    static lv_color_t pixels[COVER_ART_SIZE * COVER_ART_SIZE];
+    static lv_img_dsc_t cover;
+    for (int y = 0; y < COVER_ART_SIZE; y++) {
+        for (int x = 0; x < COVER_ART_SIZE; x++) {
+            pixels[y * COVER_ART_SIZE + x] = lv_color_make(x * 255 / COVER_ART_SIZE, 80, y * 255 / COVER_ART_SIZE);
+        }
+    }
+    cover.header.always_zero = 0;
+    cover.header.w = COVER_ART_SIZE;
+    cover.header.h = COVER_ART_SIZE;
+    cover.header.cf = LV_IMG_CF_TRUE_COLOR;
+    cover.data_size = sizeof(pixels);
+    cover.data = (const uint8_t *)pixels;
+
+    postLvglLabelText(song_title_label, "Never Gonna Give You Up");
+    postLvglLabelText(artist_label, "Rick Astley");
+    postLvglLabelText(play_label, LV_SYMBOL_PAUSE);
+    postLvglImageSrc(cover_art, &cover);
+    postLvglFlag(cover_art, LV_OBJ_FLAG_HIDDEN, false);
+    updatePlaybackClock(60000, 213000, true);
+}
+
+static void touchPlay()
+{
+    lv_area_t a;
+    lv_obj_get_coords(play_btn, &a);
+    amoled.setTouch((a.x1 + a.x2) / 2, (a.y1 + a.y2) / 2, true);
+}
+
+static void releaseTouch()
+{
+    amoled.setTouch(0, 0, false);
+}
+
+static void pressHome()
+{
+    amoled.pressHomeButton();
+}
+
+static bool readReference(const char *path, std::map<std::string, uint32_t> *ref)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Cannot read %s\n", path);
+        return false;
+    }
+    char name[64];
+    unsigned hash;
+    while (fscanf(f, "%63s %x", name, &hash) == 2) {
+        (*ref)[name] = hash;
+    }
+    fclose(f);
+    return true;
+}
+
+static bool writeHashes(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "Cannot write %s\n", path);
+        return false;
+    }
+    for (const SceneResult &r : results) {
+        fprintf(f, "%s %08x\n", r.name.c_str(), r.hash);
+    }
+    fclose(f);
+    return true;
+}
+
+static bool writeTimings(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "Cannot write %s\n", path);
+        return false;
+    }
+    fprintf(f, "scene,frames,render_us,max_frame_us,flushes,pixels,bytes,bus_us\n");
+    for (const SceneResult &r : results) {
+        fprintf(f, "%s,%u,%.0f,%.0f,%u,%llu,%llu,%llu\n", r.name.c_str(), r.frames, r.renderUs, r.maxFrameUs,
+                r.flushes, (unsigned long long)r.pixels, (unsigned long long)r.bytes, (unsigned long long)r.busUs);
+    }
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const char *reference = NULL;
+    const char *update = NULL;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--out")) {
+            outDir = argv[i + 1];
+        } else if (!strcmp(argv[i], "--reference")) {
+            reference = argv[i + 1];
+        } else if (!strcmp(argv[i], "--update-reference")) {
+            update = argv[i + 1];
+        } else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    if (!initDisplay()) {
+        fprintf(stderr, "Display initialization failed\n");
+        return 1;
+    }
+    setupUI();
+
+    scene("boot", 300, NULL);
+    scene("clock", 300, showClock);
+    scene("minute", 300, showMinuteChange);
+    scene("now_playing", 300, showNowPlaying);
+    // Two seconds of the progress bar moving on its own
+    scene("progress", 2000, NULL);
+    scene("play_pressed", 150, touchPlay);
+    scene("play_released", 300, releaseTouch);
+    scene("info_panel", 300, pressHome);
+
+    bool ok = true;
+    if (playClicks != 1) {
+        fprintf(stderr, "Play button clicked %d times, expected once\n", playClicks);
+        ok = false;
+    }
+
+    printf("%-14s %6s %10s %10s %8s %10s %10s  %s\n", "scene", "frames", "render us", "max us", "flushes", "pixels", "bus us", "hash");
+    for (const SceneResult &r : results) {
+        printf("%-14s %6u %10.0f %10.0f %8u %10llu %10llu  %08x\n", r.name.c_str(), r.frames, r.renderUs, r.maxFrameUs,
+               r.flushes, (unsigned long long)r.pixels, (unsigned long long)r.busUs, r.hash);
+    }
+    ok &= writeHashes((outDir + "/frames.txt").c_str());
+    ok &= writeTimings((outDir + "/timings.csv").c_str());
+
+    if (update) {
+        ok &= writeHashes(update);
+    } else if (reference) {
+        std::map<std::string, uint32_t> ref;
+        ok &= readReference(reference, &ref);
+        for (const SceneResult &r : results) {
+            auto it = ref.find(r.name);
+            if (it == ref.end()) {
+                fprintf(stderr, "%s: no reference frame\n", r.name.c_str());
+                ok = false;
+            } else if (it->second != r.hash) {
+                fprintf(stderr, "%s: frame %08x differs from reference %08x, see %s/%s.ppm\n",
+                        r.name.c_str(), r.hash, it->second, outDir.c_str(), r.name.c_str());
+                ok = false;
+            }
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,15 @@
+/**
+ * @file      lv_conf_host.h
+ * @brief     The board lv_conf.h with the allocator swapped for malloc,
+ *            the tiered SRAM/PSRAM pool only exists on the device
+ */
+#include "../../../src/lv_conf.h"
+
+#undef LV_MEM_CUSTOM_INCLUDE
+#undef LV_MEM_CUSTOM_ALLOC
+#undef LV_MEM_CUSTOM_FREE
+#undef LV_MEM_CUSTOM_REALLOC
+#define LV_MEM_CUSTOM_INCLUDE <stdlib.h>
+#define LV_MEM_CUSTOM_ALLOC   malloc
+#define LV_MEM_CUSTOM_FREE    free
+#define LV_MEM_CUSTOM_REALLOC realloc
@@ -0,0 +1,174 @@
+/**
+ * @file      mock_spi.cpp
+ * @brief     Host model of the ESP-IDF SPI master queue, see mock_spi.h
+ */
+
+#include "mock_spi.h"
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+#include <map>
+
+struct Pending {
+    spi_transaction_t *t;
+    spi_transaction_ext_t copy;     // Contents when queued, the owner must not touch it until returned
+    bool sent;
+};
+
+struct spi_device_t {
+    size_t queueSize;
+    int cs;
+    transaction_cb_t pre;
+    transaction_cb_t post;
+    bool eager;
+    bool failNext;
+    std::deque<Pending> queue;
+    std::vector<uint8_t> wire;
+    MockSpiStats stats;
+};
+
+static std::map<int, uint32_t> levels;
+
+#define MOCK_ERROR(dev, ...) do { (dev)->stats.errors++; fprintf(stderr, "mock_spi: " __VA_ARGS__); fputc('\n', stderr); } while (0)
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    levels[gpio_num] = level;
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num)
+{
+    auto it = levels.find(gpio_num);
+    return it == levels.end() ? 1 : (int)it->second;
+}
+
+spi_device_handle_t mock_spi_create(int queue_size, int cs, transaction_cb_t pre_cb, transaction_cb_t post_cb)
+{
+    spi_device_t *dev = new spi_device_t();
+    dev->queueSize = queue_size;
+    dev->cs = cs;
+    dev->pre = pre_cb;
+    dev->post = post_cb;
+    gpio_set_level(cs, 1);
+    return dev;
+}
+
+void mock_spi_destroy(spi_device_handle_t dev)
+{
+    delete dev;
+}
+
+void mock_spi_set_eager(spi_device_handle_t dev, bool eager)
+{
+    dev->eager = eager;
+}
+
+void mock_spi_fail_next_queue(spi_device_handle_t dev)
+{
+    dev->failNext = true;
+}
+
+std::vector<uint8_t> &mock_spi_wire(spi_device_handle_t dev)
+{
+    return dev->wire;
+}
+
+const MockSpiStats &mock_spi_stats(spi_device_handle_t dev)
+{
+    return dev->stats;
+}
+
+uint32_t mock_spi_in_flight(spi_device_handle_t dev)
+{
+    return dev->queue.size();
+}
+
+static void transfer(spi_device_t *dev, spi_transaction_t *t)
+{
+    if (dev->pre) {
+        dev->pre(t);
+    }
+    size_t bytes = t->length / 8;
+    if (bytes) {
+        if (gpio_get_level(dev->cs)) {
+            MOCK_ERROR(dev, "%zu bytes sent with CS released", bytes);
+        } else if (t->flags & SPI_TRANS_USE_TXDATA) {
+            if (bytes > 4) {
+                MOCK_ERROR(dev, "%zu bytes of tx_data", bytes);
+                bytes = 4;
+            }
+            dev->wire.insert(dev->wire.end(), t->tx_data, t->tx_data + bytes);
+        } else if (!t->tx_buffer) {
+            MOCK_ERROR(dev, "transaction of %zu bytes without a buffer", bytes);
+        } else {
+            const uint8_t *p = (const uint8_t *)t->tx_buffer;
+            dev->wire.insert(dev->wire.end(), p, p + bytes);
+        }
+    }
+    dev->stats.completed++;
+    if (dev->post) {
+        dev->post(t);
+    }
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t dev, spi_transaction_t *t, TickType_t ticks_to_wait)
+{
+    if (dev->failNext) {
+        dev->failNext = false;
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (dev->queue.size() >= dev->queueSize) {
+        // The driver would wait for a free entry, nothing else frees one here
+        MOCK_ERROR(dev, "queue of %zu entries is full", dev->queueSize);
+        return ESP_ERR_TIMEOUT;
+    }
+    for (const Pending &p : dev->queue) {
+        if (p.t == t) {
+            MOCK_ERROR(dev, "transaction %p queued while still in flight", (void *)t);
+            return ESP_ERR_INVALID_STATE;
+        }
+    }
+    Pending p;
+    p.t = t;
+    memcpy(&p.copy, t, sizeof(spi_transaction_ext_t));
+    p.sent = false;
+    dev->queue.push_back(p);
+    dev->stats.queued++;
+    if (dev->queue.size() > dev->stats.maxInFlight) {
+        dev->stats.maxInFlight = dev->queue.size();
+    }
+    if (dev->eager) {
+        dev->queue.back().sent = true;
+        transfer(dev, t);
+    }
+    return ESP_OK;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t dev, spi_transaction_t **t, TickType_t ticks_to_wait)
+{
+    if (dev->queue.empty()) {
+        MOCK_ERROR(dev, "waiting for a result with nothing queued");
+        return ESP_ERR_TIMEOUT;
+    }
+    Pending p = dev->queue.front();
+    dev->queue.pop_front();
+    if (memcmp(&p.copy, p.t, sizeof(spi_transaction_ext_t)) != 0) {
+        MOCK_ERROR(dev, "transaction %p changed while in flight", (void *)p.t);
+    }
+    if (!p.sent) {
+        transfer(dev, p.t);
+    }
+    *t = p.t;
+    return ESP_OK;
+}
+
+esp_err_t spi_device_polling_transmit(spi_device_handle_t dev, spi_transaction_t *t)
+{
+    if (!dev->queue.empty()) {
+        MOCK_ERROR(dev, "polling transaction with %zu queued", dev->queue.size());
+        return ESP_ERR_INVALID_STATE;
+    }
+    transfer(dev, t);
+    return ESP_OK;
+}
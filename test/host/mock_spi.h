@@ -0,0 +1,40 @@
+/**
+ * @file      mock_spi.h
+ * @brief     Host model of the ESP-IDF SPI master queue, used to drive DmaRing
+ *
+ * Transactions wait in a FIFO of queue_size entries like in the real driver.
+ * A transaction is "sent" when the model completes it: pre_cb runs, its bytes
+ * are appended to the wire log if CS is low, then post_cb runs. In lazy mode
+ * this happens when spi_device_get_trans_result() asks for it, in eager mode
+ * right when it is queued, as fast hardware would.
+ *
+ * Anything the real driver would block on forever or reject is counted as an
+ * error instead, so a test only has to check errors == 0.
+ */
+#pragma once
+
+#include <driver/spi_master.h>
+#include <driver/gpio.h>
+#include <vector>
+
+struct MockSpiStats {
+    uint32_t queued;
+    uint32_t completed;
+    uint32_t maxInFlight;       // Highest number of queued and not yet returned transactions
+    uint32_t errors;
+};
+
+spi_device_handle_t mock_spi_create(int queue_size, int cs, transaction_cb_t pre_cb, transaction_cb_t post_cb);
+void mock_spi_destroy(spi_device_handle_t dev);
+
+void mock_spi_set_eager(spi_device_handle_t dev, bool eager);
+
+// The next spi_device_queue_trans() is refused with ESP_ERR_INVALID_STATE
+void mock_spi_fail_next_queue(spi_device_handle_t dev);
+
+// Bytes sent while CS was low, in wire order
+std::vector<uint8_t> &mock_spi_wire(spi_device_handle_t dev);
+
+const MockSpiStats &mock_spi_stats(spi_device_handle_t dev);
+
+uint32_t mock_spi_in_flight(spi_device_handle_t dev);
@@ -0,0 +1,85 @@
+/**
+ * @file      Arduino.h
+ * @brief     Host stand-in for the parts of the Arduino core used by the UI code
+ * @note      millis() follows a virtual clock that the host program advances,
+ *            so animations and lvgl timers run the same on every machine
+ */
+#pragma once
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "esp32-hal-log.h"
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+uint32_t millis(void);
+uint32_t micros(void);
+void delay(uint32_t ms);
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+
+// Advance the virtual clock behind millis() and micros()
+void hostAdvanceMillis(uint32_t ms);
+
+// Local time reported by getLocalTime(), set by the host program
+void hostSetLocalTime(const struct tm *tm);
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+static inline void *ps_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+static inline void *ps_calloc(size_t n, size_t size)
+{
+    return calloc(n, size);
+}
+
+static inline void *ps_realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+class HostSerial
+{
+public:
+    void begin(unsigned long baud) {}
+    void flush()
+    {
+        fflush(stdout);
+    }
+    void print(const char *s)
+    {
+        fputs(s, stdout);
+    }
+    void println(const char *s = "")
+    {
+        puts(s);
+    }
+    int printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern HostSerial Serial;
+
+// Declared by the homeapp headers, not used on the host
+class String
+{
+};
+
+void configTime(long gmtOffset, int daylightOffset, const char *server1, const char *server2 = NULL);
+bool getLocalTime(struct tm *info, uint32_t ms = 5000);
+
+#endif
@@ -0,0 +1,5 @@
+/**
+ * @file      HTTPClient.h
+ * @brief     Host stand-in, only included for declarations the host programs do not use
+ */
+#pragma once
@@ -0,0 +1,12 @@
+/**
+ * @file      gpio.h
+ * @brief     Host stand-in for driver/gpio.h, levels are kept by the SPI mock
+ */
+#pragma once
+
+#include "esp_err.h"
+
+typedef int gpio_num_t;
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level);
+int gpio_get_level(gpio_num_t gpio_num);
@@ -0,0 +1,54 @@
+/**
+ * @file      spi_master.h
+ * @brief     Host stand-in for the ESP-IDF SPI master driver, implemented by mock_spi.cpp
+ * @note      Only the fields and calls used by the library are declared
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+#define SPI_TRANS_MODE_DIO          (1 << 0)
+#define SPI_TRANS_MODE_QIO          (1 << 1)
+#define SPI_TRANS_USE_RXDATA        (1 << 2)
+#define SPI_TRANS_USE_TXDATA        (1 << 3)
+#define SPI_TRANS_MODE_DIOQIO_ADDR  (1 << 4)
+#define SPI_TRANS_VARIABLE_CMD      (1 << 5)
+#define SPI_TRANS_VARIABLE_ADDR     (1 << 6)
+#define SPI_TRANS_VARIABLE_DUMMY    (1 << 7)
+#define SPI_TRANS_MULTILINE_CMD     (1 << 9)
+#define SPI_TRANS_MULTILINE_ADDR    SPI_TRANS_MODE_DIOQIO_ADDR
+
+typedef struct spi_transaction_t {
+    uint32_t flags;
+    uint16_t cmd;
+    uint64_t addr;
+    size_t length;              // Bits
+    size_t rxlength;
+    void *user;
+    union {
+        const void *tx_buffer;
+        uint8_t tx_data[4];
+    };
+    union {
+        void *rx_buffer;
+        uint8_t rx_data[4];
+    };
+} spi_transaction_t;
+
+typedef struct {
+    spi_transaction_t base;
+    uint8_t command_bits;
+    uint8_t address_bits;
+    uint8_t dummy_bits;
+} spi_transaction_ext_t;
+
+typedef void (*transaction_cb_t)(spi_transaction_t *trans);
+
+typedef struct spi_device_t *spi_device_handle_t;
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle, spi_transaction_t *trans_desc, TickType_t ticks_to_wait);
+esp_err_t spi_device_get_trans_result(spi_device_handle_t handle, spi_transaction_t **trans_desc, TickType_t ticks_to_wait);
+esp_err_t spi_device_polling_transmit(spi_device_handle_t handle, spi_transaction_t *trans_desc);
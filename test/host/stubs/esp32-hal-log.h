@@ -0,0 +1,12 @@
+/**
+ * @file      esp32-hal-log.h
+ * @brief     Host stand-in for the Arduino core log macros
+ */
+#pragma once
+
+#include <stdio.h>
+
+#define log_e(fmt, ...) fprintf(stderr, "[E] " fmt "\n", ##__VA_ARGS__)
+#define log_w(fmt, ...) fprintf(stderr, "[W] " fmt "\n", ##__VA_ARGS__)
+#define log_i(fmt, ...)
+#define log_d(fmt, ...)
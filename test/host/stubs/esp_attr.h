@@ -0,0 +1,9 @@
+/**
+ * @file      esp_attr.h
+ * @brief     Host stand-in, code placement attributes have no meaning here
+ */
+#pragma once
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_NOINIT_ATTR
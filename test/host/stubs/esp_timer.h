@@ -0,0 +1,12 @@
+/**
+ * @file      esp_timer.h
+ * @brief     Host stand-in, monotonic wall clock in microseconds
+ */
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+#endif
+int64_t esp_timer_get_time(void);
@@ -0,0 +1,28 @@
+/**
+ * @file      FreeRTOS.h
+ * @brief     Host stand-in for the FreeRTOS types used by the portable sources
+ * @note      The host programs are single threaded, critical sections are empty
+ */
+#pragma once
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef void *TaskHandle_t;
+typedef void *SemaphoreHandle_t;
+typedef void *QueueHandle_t;
+typedef int portMUX_TYPE;
+
+#define portMAX_DELAY                   ((TickType_t)0xffffffffUL)
+#define portMUX_INITIALIZER_UNLOCKED    (0)
+#define portENTER_CRITICAL(mux)         ((void)(mux))
+#define portEXIT_CRITICAL(mux)          ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux)     ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux)      ((void)(mux))
+#define pdTRUE                          (1)
+#define pdFALSE                         (0)
+#define pdPASS                          (1)
+#define pdFAIL                          (0)
+#define pdMS_TO_TICKS(ms)               ((TickType_t)(ms))
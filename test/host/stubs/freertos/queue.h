@@ -0,0 +1,10 @@
+/**
+ * @file      queue.h
+ * @brief     Host stand-in, queues are always empty
+ */
+#pragma once
+
+#include "FreeRTOS.h"
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, TickType_t ticks);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks);
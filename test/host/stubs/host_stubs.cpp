@@ -0,0 +1,105 @@
+/**
+ * @file      host_stubs.cpp
+ * @brief     Implementations behind the host stand-in headers
+ */
+
+#include "Arduino.h"
+#include "esp_timer.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <stdarg.h>
+#include <chrono>
+
+HostSerial Serial;
+
+static uint64_t virtualUs;
+static struct tm localTime;
+
+uint32_t millis(void)
+{
+    return (uint32_t)(virtualUs / 1000);
+}
+
+uint32_t micros(void)
+{
+    return (uint32_t)virtualUs;
+}
+
+void delay(uint32_t ms)
+{
+    hostAdvanceMillis(ms);
+}
+
+void hostAdvanceMillis(uint32_t ms)
+{
+    virtualUs += (uint64_t)ms * 1000;
+}
+
+void hostSetLocalTime(const struct tm *tm)
+{
+    localTime = *tm;
+}
+
+void configTime(long gmtOffset, int daylightOffset, const char *server1, const char *server2)
+{
+}
+
+bool getLocalTime(struct tm *info, uint32_t ms)
+{
+    *info = localTime;
+    return true;
+}
+
+int HostSerial::printf(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int n = vprintf(fmt, args);
+    va_end(args);
+    return n;
+}
+
+// Real time, used for the render and flush timings
+int64_t esp_timer_get_time(void)
+{
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    return duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core)
+{
+    return pdFAIL;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    hostAdvanceMillis(ticks);
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex()
+{
+    return NULL;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t sem)
+{
+    return pdTRUE;
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, TickType_t ticks)
+{
+    return pdFAIL;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks)
+{
+    return pdFAIL;
+}
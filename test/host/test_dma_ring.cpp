@@ -0,0 +1,213 @@
+/**
+ * @file      test_dma_ring.cpp
+ * @brief     Drives the QSPI transaction ring through wrap-around, a full queue,
+ *            completion in the driver callbacks and refused transactions
+ */
+
+#include "DmaRing.h"
+#include "mock_spi.h"
+#include "test_common.h"
+#include <string.h>
+#include <vector>
+
+#define CS_PIN      (6)
+
+static DmaRing_t ring;
+static spi_device_handle_t dev;
+static std::vector<uint8_t> expected;
+
+static int doneCount;
+static size_t doneWireSize;
+static bool doneCsReleased;
+
+static void onDone(void *arg)
+{
+    // Runs from post_cb, after the last byte and the CS release of the flush
+    CHECK(arg == &ring);
+    doneCount++;
+    doneWireSize = mock_spi_wire(dev).size();
+    doneCsReleased = gpio_get_level(CS_PIN) == 1;
+}
+
+static void setup(int queueSize, bool eager)
+{
+    if (dev) {
+        mock_spi_destroy(dev);
+    }
+    dev = mock_spi_create(queueSize, CS_PIN, dma_ring_pre_callback, dma_ring_post_callback);
+    mock_spi_set_eager(dev, eager);
+    dma_ring_init(&ring, dev, CS_PIN);
+    ring.done = onDone;
+    ring.doneArg = &ring;
+    expected.clear();
+    doneCount = 0;
+    doneWireSize = 0;
+    doneCsReleased = false;
+}
+
+// Same layout as LilyGo_AMOLED::queueCommand, parameters in tx_data
+static void queueCommand(const uint8_t *param, uint32_t len)
+{
+    spi_transaction_ext_t *t = dma_ring_acquire(&ring, DMA_SLOT_BEGIN | DMA_SLOT_END, AMOLED_DMA_QUEUE_SIZE);
+    t->base.flags = SPI_TRANS_MULTILINE_CMD | SPI_TRANS_MULTILINE_ADDR | SPI_TRANS_USE_TXDATA;
+    memcpy(t->base.tx_data, param, len);
+    t->base.length = 8 * len;
+    dma_ring_queue(&ring, t);
+    expected.insert(expected.end(), param, param + len);
+}
+
+// Same chunking as LilyGo_AMOLED::queueRun
+static void queueFlush(const uint16_t *data, uint32_t len, uint32_t chunk, uint8_t depth)
+{
+    uint8_t window[4] = {0x00, 0x10, 0x01, 0x2F};
+    queueCommand(window, 4);
+    queueCommand(window, 4);
+
+    bool first = true;
+    while (len > 0) {
+        uint32_t n = len < chunk ? len : chunk;
+        len -= n;
+        uint8_t flags = first ? DMA_SLOT_BEGIN : 0;
+        if (len == 0) {
+            flags |= DMA_SLOT_END | DMA_SLOT_FLUSH;
+        }
+        spi_transaction_ext_t *t = dma_ring_acquire(&ring, flags, depth);
+        t->base.flags = SPI_TRANS_MODE_QIO;
+        t->base.tx_buffer = data;
+        t->base.length = n * 16;
+        dma_ring_queue(&ring, t);
+        expected.insert(expected.end(), (const uint8_t *)data, (const uint8_t *)(data + n));
+        data += n;
+        first = false;
+    }
+}
+
+static void fillPattern(std::vector<uint16_t> &px, uint16_t seed)
+{
+    for (size_t i = 0; i < px.size(); i++) {
+        px[i] = (uint16_t)(seed + i * 31);
+    }
+}
+
+// Several flushes whose chunk counts are not multiples of the ring size, every slot gets reused at every position
+static void testWrapAround(bool eager)
+{
+    setup(AMOLED_DMA_QUEUE_SIZE, eager);
+    std::vector<uint16_t> px(1000);
+    const uint32_t sizes[] = {1000, 37, 513, 64, 999, 1};
+    int flushes = 0;
+    for (uint32_t size : sizes) {
+        fillPattern(px, (uint16_t)size);
+        queueFlush(px.data(), size, 64, AMOLED_DMA_QUEUE_SIZE);
+        flushes++;
+        if (eager) {
+            // The callbacks already ran, the last one for this flush
+            CHECK_EQ(doneCount, flushes);
+            CHECK_EQ(doneWireSize, expected.size());
+            CHECK(doneCsReleased);
+        }
+        // The next flush reuses the pixel buffer, the driver must be done with it
+        dma_ring_wait(&ring);
+        CHECK_EQ(ring.pending, 0);
+        CHECK_EQ(doneCount, flushes);
+        CHECK_EQ(doneWireSize, expected.size());
+        CHECK(doneCsReleased);
+    }
+    CHECK(mock_spi_wire(dev) == expected);
+    CHECK_EQ(mock_spi_in_flight(dev), 0);
+    CHECK_EQ(mock_spi_stats(dev).completed, mock_spi_stats(dev).queued);
+    CHECK(mock_spi_stats(dev).queued > 4 * AMOLED_DMA_QUEUE_SIZE);
+    CHECK_EQ(mock_spi_stats(dev).errors, 0);
+}
+
+// The driver queue is exactly as deep as the ring, every acquire past it has to reclaim first
+static void testFullQueue()
+{
+    setup(AMOLED_DMA_QUEUE_SIZE, false);
+    std::vector<uint16_t> px(4096);
+    fillPattern(px, 7);
+    queueFlush(px.data(), px.size(), 100, AMOLED_DMA_QUEUE_SIZE);
+    CHECK_EQ(mock_spi_stats(dev).maxInFlight, AMOLED_DMA_QUEUE_SIZE);
+    CHECK_EQ(ring.pending, mock_spi_in_flight(dev));
+    // Nothing was sent by the lazy model, so the flush is not done yet
+    CHECK(mock_spi_stats(dev).completed < mock_spi_stats(dev).queued);
+    CHECK_EQ(doneCount, 0);
+    CHECK_EQ(gpio_get_level(CS_PIN), 0);
+
+    dma_ring_wait(&ring);
+    CHECK_EQ(doneCount, 1);
+    CHECK(doneCsReleased);
+    CHECK(mock_spi_wire(dev) == expected);
+    CHECK_EQ(mock_spi_stats(dev).errors, 0);
+}
+
+// Transfers from PSRAM keep two transactions in flight at most
+static void testShallowDepth()
+{
+    setup(AMOLED_DMA_QUEUE_SIZE, false);
+    std::vector<uint16_t> px(2000);
+    fillPattern(px, 3);
+    for (int i = 0; i < 3; i++) {
+        queueFlush(px.data(), px.size(), 128, 2);
+        dma_ring_wait(&ring);
+    }
+    CHECK_EQ(mock_spi_stats(dev).maxInFlight, 2);
+    CHECK_EQ(doneCount, 3);
+    CHECK(mock_spi_wire(dev) == expected);
+    CHECK_EQ(mock_spi_stats(dev).errors, 0);
+}
+
+// A refused last chunk still releases CS and completes the flush, the ring keeps counting right
+static void testRefused(bool eager)
+{
+    setup(AMOLED_DMA_QUEUE_SIZE, eager);
+    std::vector<uint16_t> px(300);
+    fillPattern(px, 11);
+
+    // Window commands and two chunks go through, the third and last is refused
+    uint8_t window[4] = {0, 0, 0, 0};
+    queueCommand(window, 4);
+    queueCommand(window, 4);
+    for (int i = 0; i < 3; i++) {
+        uint8_t flags = i == 0 ? DMA_SLOT_BEGIN : i == 2 ? (DMA_SLOT_END | DMA_SLOT_FLUSH) : 0;
+        spi_transaction_ext_t *t = dma_ring_acquire(&ring, flags, AMOLED_DMA_QUEUE_SIZE);
+        t->base.flags = SPI_TRANS_MODE_QIO;
+        t->base.tx_buffer = px.data() + i * 100;
+        t->base.length = 100 * 16;
+        if (i == 2) {
+            mock_spi_fail_next_queue(dev);
+            CHECK(!dma_ring_queue(&ring, t));
+        } else {
+            CHECK(dma_ring_queue(&ring, t));
+        }
+    }
+    // Refusing drains the ring, the callbacks of the first chunk cannot pull CS low afterwards
+    CHECK_EQ(ring.pending, 0);
+    CHECK_EQ(mock_spi_in_flight(dev), 0);
+    CHECK_EQ(doneCount, 1);
+    CHECK_EQ(gpio_get_level(CS_PIN), 1);
+    dma_ring_wait(&ring);
+    CHECK_EQ(gpio_get_level(CS_PIN), 1);
+
+    // The next flush starts clean
+    size_t before = mock_spi_wire(dev).size();
+    expected.assign(mock_spi_wire(dev).begin(), mock_spi_wire(dev).end());
+    queueFlush(px.data(), px.size(), 64, AMOLED_DMA_QUEUE_SIZE);
+    dma_ring_wait(&ring);
+    CHECK_EQ(doneCount, 2);
+    CHECK(mock_spi_wire(dev).size() > before);
+    CHECK(mock_spi_wire(dev) == expected);
+    CHECK_EQ(mock_spi_stats(dev).errors, 0);
+}
+
+int main()
+{
+    testWrapAround(false);
+    testWrapAround(true);
+    testFullQueue();
+    testShallowDepth();
+    testRefused(false);
+    testRefused(true);
+    mock_spi_destroy(dev);
+    return TEST_RESULT();
+}
@@ -0,0 +1,227 @@
+/**
+ * @file      test_http_keepalive.cpp
+ * @brief     Pipelined requests of projects/homeapp/http_keepalive.cpp against a
+ *            local stand-in for the API server, and how a lost connection is reported
+ */
+
+#include "http_keepalive.h"
+#include "test_common.h"
+#include "test_server.h"
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#define TIMEOUT_MS      (300)
+
+static int serverPort;
+static std::mutex hitsLock;
+static std::map<std::string, int> hits;
+
+static void sendText(int fd, const std::string &text)
+{
+    send(fd, text.data(), text.size(), MSG_NOSIGNAL);
+}
+
+// Answers the requests of one connection in order, the path picks the response
+static void serveConnection(int fd)
+{
+    std::string buf;
+    char rx[1024];
+    for (;;) {
+        size_t end = buf.find("\r\n\r\n");
+        if (end == std::string::npos) {
+            ssize_t n = recv(fd, rx, sizeof(rx), 0);
+            if (n <= 0) {
+                break;
+            }
+            buf.append(rx, n);
+            continue;
+        }
+        std::string request = buf.substr(0, end);
+        buf.erase(0, end + 4);
+        size_t sp = request.find(' ');
+        std::string path = request.substr(sp + 1, request.find(' ', sp + 1) - sp - 1);
+        {
+            std::lock_guard<std::mutex> lock(hitsLock);
+            hits[path]++;
+        }
+
+        if (path == "/cl") {
+            sendText(fd, "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello");
+        } else if (path == "/ch") {
+            sendText(fd, "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                     "3\r\nabc\r\n4;ext=1\r\ndefg\r\n0\r\nX-T: 1\r\n\r\n");
+        } else if (path == "/big") {
+            sendText(fd, "HTTP/1.1 200 OK\r\nContent-Length: 3000\r\n\r\n" + std::string(3000, 'z'));
+        } else if (path == "/204") {
+            sendText(fd, "HTTP/1.1 204 No Content\r\n\r\n");
+        } else if (path == "/close") {
+            // Body delimited by the end of the connection
+            sendText(fd, "HTTP/1.0 200 OK\r\n\r\nbye");
+            break;
+        } else if (path == "/idle") {
+            // Answer, then drop the connection while the client is idle
+            sendText(fd, "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok");
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            break;
+        } else if (path == "/drop") {
+            break;
+        } else if (path == "/reset") {
+            struct linger lg = {1, 0};
+            setsockopt(fd, SOL_SOCKET, SO_LINGER, &lg, sizeof(lg));
+            break;
+        } else if (path == "/slow") {
+            // Still working on it when the client gives up
+            std::this_thread::sleep_for(std::chrono::milliseconds(TIMEOUT_MS * 2));
+            sendText(fd, "HTTP/1.1 200 OK\r\nContent-Length: 4\r\n\r\nlate");
+        } else {
+            sendText(fd, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+        }
+    }
+    close(fd);
+}
+
+static int hitCount(const char *path)
+{
+    std::lock_guard<std::mutex> lock(hitsLock);
+    return hits[path];
+}
+
+static void begin(HttpKeepAlive *conn)
+{
+    char url[48];
+    snprintf(url, sizeof(url), "http://127.0.0.1:%d", serverPort);
+    CHECK(httpKeepAliveBegin(conn, url, TIMEOUT_MS));
+}
+
+static int receive(HttpKeepAlive *conn, std::string *body)
+{
+    char buf[100];
+    size_t len;
+    int status = httpKeepAliveReceive(conn, buf, sizeof(buf), &len);
+    body->assign(buf, len);
+    return status;
+}
+
+// Mixed framings back to back on one connection, until the server ends it
+static void testPipelining()
+{
+    static HttpKeepAlive conn;
+    begin(&conn);
+    for (int round = 0; round < 3; round++) {
+        const char *paths[] = {"/cl", "/ch", "/big", "/204", "/cl", "/close"};
+        for (const char *p : paths) {
+            CHECK(httpKeepAliveSend(&conn, "GET", p));
+        }
+        std::string body;
+        CHECK_EQ(receive(&conn, &body), 200);
+        CHECK(body == "hello");
+        CHECK_EQ(receive(&conn, &body), 200);
+        CHECK(body == "abcdefg");
+        // Too large for the buffer, skipped and the connection stays usable
+        CHECK_EQ(receive(&conn, &body), HTTP_KEEPALIVE_ERR_TOO_LARGE);
+        CHECK_EQ(body.size(), 99);
+        CHECK_EQ(receive(&conn, &body), 204);
+        CHECK(body.empty());
+        CHECK_EQ(receive(&conn, &body), 200);
+        CHECK(body == "hello");
+        CHECK_EQ(receive(&conn, &body), 200);
+        CHECK(body == "bye");
+        CHECK_EQ(conn.fd, -1);
+    }
+    CHECK_EQ(conn.connects, 3);
+    CHECK_EQ(conn.requests, 18);
+}
+
+// Requests pipelined behind a response that ends the connection were not answered
+static void testClosedAfterResponse()
+{
+    static HttpKeepAlive conn;
+    begin(&conn);
+    CHECK(httpKeepAliveSend(&conn, "GET", "/close"));
+    CHECK(httpKeepAliveSend(&conn, "GET", "/cl"));
+    std::string body;
+    CHECK_EQ(receive(&conn, &body), 200);
+    CHECK(body == "bye");
+    CHECK_EQ(receive(&conn, &body), HTTP_KEEPALIVE_ERR_CLOSED);
+}
+
+// The server drops the connection instead of answering, after answering the request before
+static void testDropped()
+{
+    static HttpKeepAlive conn;
+    begin(&conn);
+    CHECK(httpKeepAliveSend(&conn, "GET", "/cl"));
+    CHECK(httpKeepAliveSend(&conn, "POST", "/drop"));
+    CHECK(httpKeepAliveSend(&conn, "GET", "/cl"));
+    std::string body;
+    CHECK_EQ(receive(&conn, &body), 200);
+    CHECK(body == "hello");
+    CHECK_EQ(httpKeepAliveReceiveHead(&conn), HTTP_KEEPALIVE_ERR_CLOSED);
+    CHECK_EQ(httpKeepAliveReceiveHead(&conn), HTTP_KEEPALIVE_ERR_CLOSED);
+    CHECK_EQ(conn.fd, -1);
+    // Reported, not sent again behind the caller's back
+    CHECK_EQ(hitCount("/drop"), 1);
+    CHECK_EQ(conn.connects, 1);
+}
+
+// A reset discards whatever was not read yet, and fails sends that race with it,
+// so it is tried on a single request
+static void testReset()
+{
+    static HttpKeepAlive conn;
+    begin(&conn);
+    CHECK(httpKeepAliveSend(&conn, "POST", "/reset"));
+    CHECK_EQ(httpKeepAliveReceiveHead(&conn), HTTP_KEEPALIVE_ERR_CLOSED);
+    CHECK_EQ(conn.fd, -1);
+    CHECK_EQ(hitCount("/reset"), 1);
+}
+
+// A server that is slow to answer times out, which must not look like a dropped request
+static void testTimeout()
+{
+    static HttpKeepAlive conn;
+    begin(&conn);
+    CHECK(httpKeepAliveSend(&conn, "POST", "/slow"));
+    auto start = std::chrono::steady_clock::now();
+    CHECK_EQ(httpKeepAliveReceiveHead(&conn), HTTP_KEEPALIVE_ERR_IO);
+    long ms = (long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    CHECK(ms >= TIMEOUT_MS - 20);
+    CHECK_EQ(conn.fd, -1);
+    CHECK_EQ(hitCount("/slow"), 1);
+}
+
+// A connection the server closed while idle is replaced before the next request goes out
+static void testIdleClosed()
+{
+    static HttpKeepAlive conn;
+    begin(&conn);
+    CHECK(httpKeepAliveSend(&conn, "GET", "/idle"));
+    std::string body;
+    CHECK_EQ(receive(&conn, &body), 200);
+    CHECK(body == "ok");
+    CHECK(conn.fd >= 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+
+    CHECK(httpKeepAliveSend(&conn, "POST", "/cl"));
+    CHECK_EQ(receive(&conn, &body), 200);
+    CHECK(body == "hello");
+    CHECK_EQ(conn.connects, 2);
+}
+
+int main()
+{
+    serverPort = startServer(serveConnection);
+    testPipelining();
+    testClosedAfterResponse();
+    testDropped();
+    testReset();
+    testTimeout();
+    testIdleClosed();
+    return TEST_RESULT();
+}
@@ -0,0 +1,97 @@
+/**
+ * @file      test_pixel_rotate.cpp
+ * @brief     Checks pixel_rotate and pixel_rotate_scalar in all four orientations
+ *            against the definition of each rotation, on tile edges and unaligned buffers
+ */
+
+#include "PixelKernel.h"
+#include "test_common.h"
+#include <stdint.h>
+#include <string.h>
+#include <random>
+#include <vector>
+
+#define GUARD       (64)
+#define GUARD_VALUE (0xA55A)
+
+static std::mt19937 rng(1234);
+
+// Position in the source of the pixel that lands at row r, column c of the destination
+static uint32_t source_index(uint16_t w, uint16_t h, uint8_t rotation, uint32_t r, uint32_t c)
+{
+    switch (rotation) {
+    case 1:
+        return (h - 1 - c) * w + r;
+    case 2:
+        return (h - 1 - r) * w + (w - 1 - c);
+    case 3:
+        return c * w + (w - 1 - r);
+    default:
+        return r * w + c;
+    }
+}
+
+static bool check(void (*fn)(const uint16_t *, uint16_t *, uint16_t, uint16_t, uint8_t),
+                  uint16_t w, uint16_t h, uint8_t rotation, uint32_t dstOffset)
+{
+    uint32_t len = (uint32_t)w * h;
+    std::vector<uint16_t> src(len);
+    std::vector<uint16_t> dst(dstOffset + len + GUARD, GUARD_VALUE);
+    for (uint32_t i = 0; i < len; i++) {
+        src[i] = (uint16_t)rng();
+    }
+    fn(src.data(), dst.data() + dstOffset, w, h, rotation);
+
+    uint32_t dstWidth = (rotation & 1) ? h : w;
+    uint32_t dstHeight = (rotation & 1) ? w : h;
+    for (uint32_t r = 0; r < dstHeight; r++) {
+        for (uint32_t c = 0; c < dstWidth; c++) {
+            if (dst[dstOffset + r * dstWidth + c] != src[source_index(w, h, rotation, r, c)]) {
+                fprintf(stderr, "%ux%u rotation:%u offset:%u wrong pixel at %u,%u\n", w, h, rotation, dstOffset, c, r);
+                return false;
+            }
+        }
+    }
+    for (uint32_t i = 0; i < dstOffset; i++) {
+        if (dst[i] != GUARD_VALUE) {
+            fprintf(stderr, "%ux%u rotation:%u wrote before the destination\n", w, h, rotation);
+            return false;
+        }
+    }
+    for (uint32_t i = dstOffset + len; i < dst.size(); i++) {
+        if (dst[i] != GUARD_VALUE) {
+            fprintf(stderr, "%ux%u rotation:%u wrote past the destination\n", w, h, rotation);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    // Board frames, sizes around the tile edge and degenerate strips
+    const uint16_t sizes[][2] = {
+        {368, 194}, {194, 368}, {600, 450}, {536, 240},
+        {PIXEL_ROTATE_TILE, PIXEL_ROTATE_TILE},
+        {PIXEL_ROTATE_TILE - 1, PIXEL_ROTATE_TILE + 1},
+        {PIXEL_ROTATE_TILE + 1, 2 * PIXEL_ROTATE_TILE - 1},
+        {33, 17}, {17, 33}, {2, 2}, {3, 5}, {1, 7}, {7, 1}, {1, 1},
+    };
+    for (auto &s : sizes) {
+        for (uint8_t r = 0; r < 4; r++) {
+            // An odd offset leaves the destination rows unaligned for the 32-bit stores
+            for (uint32_t offset = 0; offset < 2; offset++) {
+                CHECK(check(pixel_rotate_scalar, s[0], s[1], r, offset));
+                CHECK(check(pixel_rotate, s[0], s[1], r, offset));
+            }
+        }
+    }
+    // Random sizes
+    for (int i = 0; i < 200; i++) {
+        uint16_t w = 1 + rng() % 150;
+        uint16_t h = 1 + rng() % 150;
+        uint8_t r = rng() % 4;
+        CHECK(check(pixel_rotate, w, h, r, rng() % 2));
+    }
+    return TEST_RESULT();
+}
@@ -0,0 +1,39 @@
+/**
+ * @file      test_server.h
+ * @brief     Loopback stand-in for the API server shared by the host tests
+ */
+#pragma once
+
+#include <thread>
+#include <string.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+/**
+ * @brief Listen on a free port of 127.0.0.1, every connection runs serve(fd) on its own thread
+ * @note  serve() owns the socket and closes it
+ * @return The port
+ */
+static int startServer(void (*serve)(int fd))
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+    listen(fd, 8);
+    socklen_t len = sizeof(addr);
+    getsockname(fd, (struct sockaddr *)&addr, &len);
+    std::thread([fd, serve] {
+        for (;;) {
+            int c = accept(fd, NULL, NULL);
+            if (c < 0) {
+                break;
+            }
+            std::thread(serve, c).detach();
+        }
+    }).detach();
+    return ntohs(addr.sin_port);
+}
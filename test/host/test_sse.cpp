@@ -0,0 +1,220 @@
+/**
+ * @file      test_sse.cpp
+ * @brief     Server-Sent Events of projects/homeapp/sse_parser.cpp, read through
+ *            the stream of http_keepalive.cpp from a local stand-in for the API server
+ */
+
+#include "http_keepalive.h"
+#include "sse_parser.h"
+#include "test_common.h"
+#include "test_server.h"
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#define TIMEOUT_MS      (1000)
+
+static int serverPort;
+static std::vector<std::string> events;
+
+static void onEvent(const char *event, const char *data, size_t len, void *arg)
+{
+    CHECK_EQ(strlen(data), len);
+    events.push_back(std::string(event) + "|" + std::string(data, len));
+}
+
+static void sendText(int fd, const std::string &text)
+{
+    send(fd, text.data(), text.size(), MSG_NOSIGNAL);
+}
+
+static void sendChunk(int fd, const std::string &text)
+{
+    char size[16];
+    snprintf(size, sizeof(size), "%zx\r\n", text.size());
+    sendText(fd, size + text + "\r\n");
+}
+
+static void waitForClient()
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+}
+
+// The events of a connection as the server sends them, in several chunks
+static void sendEvents(int fd)
+{
+    sendChunk(fd, ": hello\n\nevent: status\ndata: {\"isLoggedIn\":true}\n\n");
+    sendChunk(fd, "event: state\ndata: {\"isPlaying\":true,\"title\":\"A\",\ndata: \"artists\":[\"x\",\"y\"],\"id\":\"1\"}\n\n");
+    // An event split across chunks, with CRLF line endings
+    sendChunk(fd, "event: diff\r\ndata: {\"ti");
+    waitForClient();
+    sendChunk(fd, "tle\":\"B\"}\r\n\r\n");
+    sendChunk(fd, ":\n\nevent: diff\ndata: {\"isPlaying\":false}\n\n");
+}
+
+static void serveConnection(int fd)
+{
+    std::string request;
+    char rx[512];
+    while (request.find("\r\n\r\n") == std::string::npos) {
+        ssize_t n = recv(fd, rx, sizeof(rx), 0);
+        if (n <= 0) {
+            close(fd);
+            return;
+        }
+        request.append(rx, n);
+    }
+    size_t sp = request.find(' ');
+    std::string path = request.substr(sp + 1, request.find(' ', sp + 1) - sp - 1);
+    const char *streamHead = "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream; charset=utf-8\r\n"
+                             "Transfer-Encoding: chunked\r\n\r\n";
+
+    if (path == "/events") {
+        sendText(fd, streamHead);
+        sendEvents(fd);
+        sendText(fd, "0\r\n\r\n");
+    } else if (path == "/drop") {
+        // The stream ends without its last chunk
+        sendText(fd, streamHead);
+        sendEvents(fd);
+        waitForClient();
+    } else if (path == "/cover") {
+        // A state event still carrying the cover does not fit, the next one does
+        sendText(fd, streamHead);
+        sendChunk(fd, "event: state\ndata: {\"id\":\"1\",\"coverSmall\":\"data:image/jpeg;base64," +
+                  std::string(3000, 'A') + "\"}\n\n");
+        sendChunk(fd, "event: diff\ndata: {\"id\":\"2\"}\n\n");
+        sendText(fd, "0\r\n\r\n");
+    } else if (path == "/json") {
+        sendText(fd, "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: 2\r\n\r\n{}");
+    } else {
+        sendText(fd, "HTTP/1.1 404 Not Found\r\nContent-Length: 9\r\n\r\nnot found");
+    }
+    close(fd);
+}
+
+// Reads the stream as the push task does, with small reads to split lines further
+static int session(const char *path, uint32_t *dropped)
+{
+    static HttpKeepAlive conn;
+    static SseParser parser;
+    char url[48];
+    snprintf(url, sizeof(url), "http://127.0.0.1:%d", serverPort);
+    CHECK(httpKeepAliveBegin(&conn, url, TIMEOUT_MS));
+    events.clear();
+    int status = httpKeepAliveStreamOpen(&conn, path, "text/event-stream", TIMEOUT_MS);
+    if (status != 200) {
+        CHECK_EQ(conn.fd, -1);
+        return status;
+    }
+    sseParserBegin(&parser, onEvent, NULL);
+    char buf[7];
+    int n;
+    while ((n = httpKeepAliveBodyRead(&conn, buf, sizeof(buf))) > 0) {
+        sseParserFeed(&parser, buf, n);
+    }
+    CHECK_EQ(conn.fd, -1);
+    if (dropped) {
+        *dropped = parser.dropped;
+    }
+    return status;
+}
+
+static void checkEvents()
+{
+    CHECK_EQ(events.size(), 4);
+    if (events.size() == 4) {
+        CHECK(events[0] == "status|{\"isLoggedIn\":true}");
+        CHECK(events[1] == "state|{\"isPlaying\":true,\"title\":\"A\",\n\"artists\":[\"x\",\"y\"],\"id\":\"1\"}");
+        CHECK(events[2] == "diff|{\"title\":\"B\"}");
+        CHECK(events[3] == "diff|{\"isPlaying\":false}");
+    }
+}
+
+static void testStream()
+{
+    uint32_t dropped = 1;
+    CHECK_EQ(session("/events", &dropped), 200);
+    checkEvents();
+    CHECK_EQ(dropped, 0);
+}
+
+// Events that arrived before the connection was lost are all delivered
+static void testDropped()
+{
+    CHECK_EQ(session("/drop", NULL), 200);
+    checkEvents();
+}
+
+static void testOversized()
+{
+    uint32_t dropped = 0;
+    CHECK_EQ(session("/cover", &dropped), 200);
+    CHECK_EQ(dropped, 1);
+    CHECK_EQ(events.size(), 1);
+    if (events.size() == 1) {
+        CHECK(events[0] == "diff|{\"id\":\"2\"}");
+    }
+}
+
+// A server that does not stream the path, the caller falls back to polling
+static void testNotStreamed()
+{
+    CHECK_EQ(session("/spotify/events", NULL), 404);
+    CHECK_EQ(session("/json", NULL), HTTP_KEEPALIVE_ERR_PROTOCOL);
+}
+
+// Field rules of the format, fed in every possible split of the same bytes
+static void testParser()
+{
+    const char *text = ": hi\r\nevent: state\r\ndata: {\"a\":1}\r\n\r\n"
+                       "event: diff\ndata: x\ndata: y\n\n"
+                       "data\n\nid: 3\nretry: 10\n\n"
+                       "event: e\rdata:z\r\r";
+    const std::vector<std::string> expected = {
+        "state|{\"a\":1}",
+        "diff|x\ny",
+        "message|",
+        "e|z",
+    };
+    size_t len = strlen(text);
+    static SseParser parser;
+    for (size_t a = 0; a <= len; a++) {
+        for (size_t b = a; b <= len; b++) {
+            events.clear();
+            sseParserBegin(&parser, onEvent, NULL);
+            sseParserFeed(&parser, text, a);
+            sseParserFeed(&parser, text + a, b - a);
+            sseParserFeed(&parser, text + b, len - b);
+            if (events != expected) {
+                fprintf(stderr, "split at %zu and %zu\n", a, b);
+                CHECK(events == expected);
+                return;
+            }
+        }
+    }
+
+    // A line longer than the buffer drops its event only
+    std::string longLine = "data: " + std::string(SSE_DATA_LEN, 'x') + "\n\ndata: ok\n\n";
+    events.clear();
+    sseParserBegin(&parser, onEvent, NULL);
+    sseParserFeed(&parser, longLine.data(), longLine.size());
+    CHECK_EQ(parser.dropped, 1);
+    CHECK_EQ(events.size(), 1);
+    CHECK(events.size() == 1 && events[0] == "message|ok");
+}
+
+int main()
+{
+    serverPort = startServer(serveConnection);
+    testParser();
+    testStream();
+    testDropped();
+    testOversized();
+    testNotStreamed();
+    return TEST_RESULT();
+}